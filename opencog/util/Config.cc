@@ -30,9 +30,17 @@
 #include <sstream>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+
+#include <climits>
+#include <chrono>
 
 #include <errno.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
 
 // For backward compatibility as from boost 1.46 filesystem 3 is the default
 // as of boost 1.50 there is no version 2, and compiles will fail ;-(
@@ -71,20 +79,27 @@ Config* Config::createInstance()
 
 Config::~Config()
 {
+    unwatch();
 }
 
 Config::Config()
+    : _version(0), _watching(false)
 {
+    install(std::make_shared<ConfigSnapshot>());
     reset();
 }
 
 void Config::reset()
 {
-    _table.clear();
+    {
+        std::lock_guard<std::mutex> lck(_table_mtx);
+        _table.clear();
+    }
     _no_config_loaded = true;
     _had_to_search = true;
     _abs_path = "";
     _cfg_filename = "";
+    publish();
 }
 
 static const char* DEFAULT_CONFIG_FILENAME = "opencog.conf";
@@ -166,6 +181,7 @@ void Config::load(const char* filename, bool resetFirst)
     if (resetFirst) reset();
 
     _cfg_filename = filename;
+    _path_where_found.clear();
 
     ifstream fin;
 
@@ -207,6 +223,33 @@ void Config::load(const char* filename, bool resetFirst)
 
     _no_config_loaded = false;
 
+    // Store the entries only once the whole file was parsed.
+    std::map<string, string> table;
+    parse(fin, path_where_found(), table);
+    {
+        std::lock_guard<std::mutex> lck(_table_mtx);
+        for (auto& entry : table)
+            _table[entry.first] = std::move(entry.second);
+    }
+    fin.close();
+    publish();
+
+    // Finish configuring the logger... The config file itself
+    // contains the location of the log file. This is working around
+    // a chicken-and-egg problem with reporting config file issues.
+    // Such is life; this is a lot easier than debugging screwed-up
+    // file-path craziness in a debugger. We MUST log the path!!!
+    setup_logger();
+
+    // And then finally, at long last!!! report what happened.
+    logger().info("Using config file found at: %s\n",
+                  path_where_found().c_str());
+}
+
+// Parse the entries of a config file into table.
+void Config::parse(std::istream& fin, const std::string& path,
+                   std::map<std::string, std::string>& table)
+{
     string line;
     string name;
     string value;
@@ -265,7 +308,7 @@ void Config::load(const char* filename, bool resetFirst)
             // than debugging the thrown exception in a debugger.
             setup_logger();
             logger().warn("Invalid config file entry at line %d in %s\n",
-                  line_number, path_where_found().c_str());
+                  line_number, path.c_str());
 
             throw InvalidParamException(TRACE_INFO,
                   "[ERROR] invalid configuration entry (line %d)",
@@ -275,24 +318,12 @@ void Config::load(const char* filename, bool resetFirst)
         if (have_name && have_value)
         {
             // Finally, store the entries.
-            _table[name] = value;
+            table[name] = value;
             have_name = false;
             have_value = false;
             value = "";
         }
     }
-    fin.close();
-
-    // Finish configuring the logger... The config file itself
-    // contains the location of the log file. This is working around
-    // a chicken-and-egg problem with reporting config file issues.
-    // Such is life; this is a lot easier than debugging screwed-up
-    // file-path craziness in a debugger. We MUST log the path!!!
-    setup_logger();
-
-    // And then finally, at long last!!! report what happened.
-    logger().info("Using config file found at: %s\n",
-                  path_where_found().c_str());
 }
 
 void Config::setup_logger()
@@ -309,41 +340,61 @@ void Config::setup_logger()
         logger().set_timestamp_flag(get_bool("LOG_TIMESTAMP"));
 }
 
-const bool Config::has(const string &name) const
+// Copy the value of name into value, if not NULL, and return true if
+// the parameter exists.
+bool Config::lookup(const string& name, string* value) const
 {
     if (_no_config_loaded)
         logger().warn("No configuration file was loaded! Param=%s",
                       name.c_str());
-    return (_table.find(name) != _table.end());
+    std::lock_guard<std::mutex> lck(_table_mtx);
+    auto it = _table.find(name);
+    if (it == _table.end()) return false;
+    if (value) *value = it->second;
+    return true;
+}
+
+const bool Config::has(const string &name) const
+{
+    return lookup(name, NULL);
 }
 
 void Config::set(const std::string &parameter_name,
                  const std::string &parameter_value)
 {
     _no_config_loaded = false;
-    _table[parameter_name] = parameter_value;
+    bool registered;
+    {
+        std::lock_guard<std::mutex> lck(_table_mtx);
+        _table[parameter_name] = parameter_value;
+        registered = _slots.find(parameter_name) != _slots.end();
+    }
+    if (registered) publish();
 }
 
-const string& Config::get(const string& name, const string& dfl) const
+string Config::get(const string& name, const string& dfl) const
 {
-    if (not has(name)) return dfl;
-    return _table.find(name)->second;
+    string value;
+    if (not lookup(name, &value)) return dfl;
+    return value;
 }
 
-const string& Config::operator[](const string &name) const
+string Config::operator[](const string &name) const
 {
-    if (not has(name))
+    string value;
+    if (not lookup(name, &value))
        throw InvalidParamException(TRACE_INFO,
                                    "[ERROR] parameter not found (%s)",
                                    name.c_str());
-    return _table.find(name)->second;
+    return value;
 }
 
 int Config::get_int(const string &name, int dfl) const
 {
-    if (not has(name)) return dfl;
+    string value;
+    if (not lookup(name, &value)) return dfl;
     try {
-        return boost::lexical_cast<int>(get(name));
+        return boost::lexical_cast<int>(value);
     } catch (boost::bad_lexical_cast&) {
         throw InvalidParamException(TRACE_INFO,
                "[ERROR] invalid integer parameter (%s)",
@@ -353,9 +404,10 @@ int Config::get_int(const string &name, int dfl) const
 
 long Config::get_long(const string &name, long dfl) const
 {
-    if (not has(name)) return dfl;
+    string value;
+    if (not lookup(name, &value)) return dfl;
     try {
-        return boost::lexical_cast<long>(get(name));
+        return boost::lexical_cast<long>(value);
     } catch (boost::bad_lexical_cast&) {
         throw InvalidParamException(TRACE_INFO,
                "[ERROR] invalid long integer parameter (%s)",
@@ -365,9 +417,10 @@ long Config::get_long(const string &name, long dfl) const
 
 double Config::get_double(const string &name, double dfl) const
 {
-    if (not has(name)) return dfl;
+    string value;
+    if (not lookup(name, &value)) return dfl;
     try {
-        return boost::lexical_cast<double>(get(name));
+        return boost::lexical_cast<double>(value);
     } catch (boost::bad_lexical_cast&) {
         throw InvalidParamException(TRACE_INFO,
                "[ERROR] invalid double parameter (%s)",
@@ -377,17 +430,19 @@ double Config::get_double(const string &name, double dfl) const
 
 bool Config::get_bool(const string &name, bool dfl) const
 {
-    if (not has(name)) return dfl;
-    if (boost::iequals(get(name), "true")) return true;
-    else if (boost::iequals(get(name), "false")) return false;
+    string value;
+    if (not lookup(name, &value)) return dfl;
+    if (boost::iequals(value, "true")) return true;
+    else if (boost::iequals(value, "false")) return false;
     else throw InvalidParamException(TRACE_INFO,
                 "[ERROR] invalid bool parameter (%s: %s)",
-                name.c_str(), get(name).c_str());
+                name.c_str(), value.c_str());
 }
 
 std::string Config::to_string() const
 {
     std::ostringstream oss;
+    std::lock_guard<std::mutex> lck(_table_mtx);
     oss << "{\"";
     for (auto it = _table.begin(); it != _table.end(); ++it) {
         if (it != _table.begin()) oss << "\", \"";
@@ -397,6 +452,274 @@ std::string Config::to_string() const
     return oss.str();
 }
 
+// Parse a value once into every type a handle can ask for.
+static void parse_value(ConfigValue& v, const string& str)
+{
+    v.present = true;
+    v.str = str;
+    try {
+        v.long_value = boost::lexical_cast<long>(str);
+        v.long_ok = true;
+    } catch (boost::bad_lexical_cast&) {}
+    try {
+        v.double_value = boost::lexical_cast<double>(str);
+        v.double_ok = true;
+    } catch (boost::bad_lexical_cast&) {}
+    if (boost::iequals(str, "true")) {
+        v.bool_value = true;
+        v.bool_ok = true;
+    } else if (boost::iequals(str, "false")) {
+        v.bool_value = false;
+        v.bool_ok = true;
+    }
+}
+
+size_t Config::register_param(const string& name)
+{
+    std::unique_lock<std::mutex> lck(_table_mtx);
+    auto it = _slots.find(name);
+    if (it != _slots.end()) return it->second;
+
+    size_t slot = _slots.size();
+    _slots[name] = slot;
+
+    // Extend the current snapshot with the new slot. Nothing changed
+    // from the point of view of existing handles, so don't signal.
+    auto snap = std::make_shared<ConfigSnapshot>(*_snapshot);
+    snap->names.push_back(name);
+    snap->values.emplace_back();
+    auto tit = _table.find(name);
+    if (tit != _table.end())
+        parse_value(snap->values.back(), tit->second);
+
+    install(std::move(snap));
+    return slot;
+}
+
+// Versions are unique among all Configs, so that a thread's cache
+// never mistakes the snapshot of a Config for that of another.
+static std::atomic<uint64_t> next_version(1);
+
+// Make snap the current snapshot. The caller holds _table_mtx, unless
+// it is the constructor.
+void Config::install(std::shared_ptr<const ConfigSnapshot> snap)
+{
+    _snapshot = std::move(snap);
+    _version.store(next_version++, std::memory_order_release);
+}
+
+void Config::refresh(SnapshotCache& cache) const
+{
+    std::lock_guard<std::mutex> lck(_table_mtx);
+    cache.snapshot = _snapshot;
+    cache.version = _version.load(std::memory_order_relaxed);
+}
+
+void Config::publish()
+{
+    std::vector<size_t> changed;
+    std::shared_ptr<const ConfigSnapshot> snap;
+    {
+        std::unique_lock<std::mutex> lck(_table_mtx);
+        std::shared_ptr<const ConfigSnapshot> old = _snapshot;
+        auto fresh = std::make_shared<ConfigSnapshot>();
+        fresh->names = old->names;
+        fresh->values.resize(old->values.size());
+        for (size_t i = 0; i < fresh->names.size(); i++)
+        {
+            auto tit = _table.find(fresh->names[i]);
+            if (tit != _table.end())
+                parse_value(fresh->values[i], tit->second);
+
+            const ConfigValue& ov = old->values[i];
+            const ConfigValue& nv = fresh->values[i];
+            if (ov.present != nv.present or ov.str != nv.str)
+                changed.push_back(i);
+        }
+        snap = fresh;
+        install(std::move(fresh));
+    }
+
+    // Signal outside of the lock, so that slots may call back in.
+    for (size_t i : changed)
+        _changed.emit(snap->names[i], snap->values[i].str);
+}
+
+void Config::reload()
+{
+    if (_path_where_found.empty())
+        throw IOException(TRACE_INFO,
+             "[ERROR] no config file has been loaded; cannot reload");
+    reload_file(_path_where_found);
+}
+
+// Don't reset(): that would publish an empty snapshot, and readers
+// would briefly see defaults. Parse into a scratch table instead, and
+// swap it in, so that a broken file leaves everything in place.
+void Config::reload_file(const std::string& path)
+{
+    std::unique_lock<std::mutex> lck(_reload_mtx);
+    ifstream fin(path.c_str());
+    if (not fin.is_open())
+        throw IOException(TRACE_INFO,
+             "unable to open file \"%s\"", path.c_str());
+
+    std::map<std::string, std::string> table;
+    parse(fin, path, table);
+    {
+        std::lock_guard<std::mutex> tlck(_table_mtx);
+        _table.swap(table);
+    }
+    _no_config_loaded = false;
+    publish();
+    setup_logger();
+}
+
+void Config::watch()
+{
+    if (_watching.load()) return;
+    if (_path_where_found.empty())
+        throw IOException(TRACE_INFO,
+             "[ERROR] no config file has been loaded; cannot watch");
+
+    _watching.store(true);
+    std::promise<void> ready;
+    std::future<void> started = ready.get_future();
+    _watcher = std::thread(&Config::watch_loop, this, _path_where_found,
+                           std::move(ready));
+    // Don't miss the changes made right after watch() returns.
+    started.wait();
+}
+
+void Config::unwatch()
+{
+    if (not _watching.exchange(false)) return;
+    if (_watcher.joinable()) _watcher.join();
+}
+
+// The watcher thread reloads the path it was given, and never reads
+// the members that load() may change meanwhile.
+void Config::try_reload(const std::string& path)
+{
+    try {
+        reload_file(path);
+        logger().info("Config file reloaded: %s\n", path.c_str());
+    } catch (const StandardException& ex) {
+        logger().warn("Config file reload failed: %s\n", ex.what());
+    }
+}
+
+#ifdef __linux__
+
+// Watch the directory rather than the file itself: editors and
+// deployment tools usually replace a file by renaming a new one over
+// it, which would silently orphan a watch on the old inode.
+void Config::watch_loop(std::string path, std::promise<void> ready)
+{
+    boost::filesystem::path fp(path);
+    std::string dir = fp.parent_path().string();
+    std::string base = fp.filename().string();
+    if (dir.empty()) dir = ".";
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0 or
+        inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        logger().warn("Cannot watch config file %s: %s\n",
+                      path.c_str(), strerror(errno));
+        if (0 <= fd) close(fd);
+        ready.set_value();
+        return;
+    }
+    ready.set_value();
+
+    alignas(struct inotify_event) char buf[4096];
+    while (_watching.load())
+    {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        if (poll(&pfd, 1, 200) <= 0) continue;
+
+        bool hit = false;
+        ssize_t len;
+        while (0 < (len = read(fd, buf, sizeof(buf))))
+        {
+            for (char* p = buf; p < buf + len; )
+            {
+                struct inotify_event* ev = (struct inotify_event*) p;
+                if (ev->len and base == ev->name) hit = true;
+                p += sizeof(struct inotify_event) + ev->len;
+            }
+        }
+        if (hit) try_reload(path);
+    }
+    close(fd);
+}
+
+#else // __linux__
+
+void Config::watch_loop(std::string path, std::promise<void> ready)
+{
+    boost::system::error_code ec;
+    std::time_t last = boost::filesystem::last_write_time(path, ec);
+    ready.set_value();
+    while (_watching.load())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::time_t now = boost::filesystem::last_write_time(path, ec);
+        if (ec or now == last) continue;
+        last = now;
+        try_reload(path);
+    }
+}
+
+#endif // __linux__
+
+template<>
+int ConfigParam<int>::cast(const ConfigValue& v, const string& name)
+{
+    if (not v.long_ok or v.long_value < INT_MIN or INT_MAX < v.long_value)
+        throw InvalidParamException(TRACE_INFO,
+               "[ERROR] invalid integer parameter (%s)",
+               name.c_str());
+    return (int) v.long_value;
+}
+
+template<>
+long ConfigParam<long>::cast(const ConfigValue& v, const string& name)
+{
+    if (not v.long_ok)
+        throw InvalidParamException(TRACE_INFO,
+               "[ERROR] invalid long integer parameter (%s)",
+               name.c_str());
+    return v.long_value;
+}
+
+template<>
+double ConfigParam<double>::cast(const ConfigValue& v, const string& name)
+{
+    if (not v.double_ok)
+        throw InvalidParamException(TRACE_INFO,
+               "[ERROR] invalid double parameter (%s)",
+               name.c_str());
+    return v.double_value;
+}
+
+template<>
+bool ConfigParam<bool>::cast(const ConfigValue& v, const string& name)
+{
+    if (not v.bool_ok)
+        throw InvalidParamException(TRACE_INFO,
+                "[ERROR] invalid bool parameter (%s: %s)",
+                name.c_str(), v.str.c_str());
+    return v.bool_value;
+}
+
+template<>
+string ConfigParam<string>::cast(const ConfigValue& v, const string&)
+{
+    return v.str;
+}
+
 // create and return the single instance
 Config& opencog::config(ConfigFactory* factoryFunction,
                         bool overwrite)
@@ -25,36 +25,133 @@
 #ifndef _OPENCOG_CONFIG_H
 #define _OPENCOG_CONFIG_H
 
+#include <atomic>
+#include <cstdint>
 #include <fstream>
+#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <opencog/util/sigslot.h>
+
 namespace opencog
 {
 /** \addtogroup grp_cogutil
  *  @{
  */
 
+template<typename T> class ConfigParam;
+
+//! A parameter value, parsed once into every type a handle may ask for.
+struct ConfigValue
+{
+    bool present = false;
+    std::string str;
+    long long_value = 0;
+    double double_value = 0.0;
+    bool bool_value = false;
+    bool long_ok = false;
+    bool double_ok = false;
+    bool bool_ok = false;
+};
+
+//! Immutable set of parsed values, indexed by parameter handle slot.
+struct ConfigSnapshot
+{
+    std::vector<std::string> names;
+    std::vector<ConfigValue> values;
+};
+
 //! library-wide configuration; keys and values are strings
+/**
+ * Besides the string-keyed accessors, parameters can be read through
+ * typed handles obtained with param<T>(). A handle is parsed once,
+ * when the configuration changes, and reading it is a single atomic
+ * pointer load: no lock, no map lookup, no lexical_cast.
+ *
+ * Changes are published RCU-style: set(), load() and reload() build
+ * a fresh snapshot of all registered parameters and swap it in, with
+ * a new version number. Each thread keeps a shared_ptr on the last
+ * snapshot it read, and only takes the lock to refresh it when the
+ * version changed, so a snapshot is freed once no thread holds it.
+ *
+ * The string-keyed accessors lock the table, and return copies of
+ * its values, so they may be used while watch() reloads the file in
+ * the background; handles are still much cheaper to read.
+ */
 class Config
 {
+    template<typename T> friend class ConfigParam;
+
+public:
+    //! Emitted after a change was published, once per changed
+    //! registered parameter, with its name and new string value.
+    typedef SigSlot<const std::string&, const std::string&> ChangeSignal;
+
 protected:
     std::map<std::string, std::string> _table;
-    bool _no_config_loaded;
+    std::atomic<bool> _no_config_loaded;
     bool _had_to_search;
     std::string _path_where_found;
     std::string _abs_path;
     std::string _cfg_filename;
 
+    // Guards _table, the parameter handle registry and the published
+    // snapshots.
+    mutable std::mutex _table_mtx;
+    std::map<std::string, size_t> _slots;
+    std::shared_ptr<const ConfigSnapshot> _snapshot;
+    // Version of _snapshot, unique among all Configs
+    std::atomic<uint64_t> _version;
+    ChangeSignal _changed;
+
+    // Background file watcher.
+    std::mutex _reload_mtx;
+    std::thread _watcher;
+    std::atomic<bool> _watching;
+
     void check_for_file(std::ifstream&, const char *, const char *);
     void setup_logger();
+    void parse(std::istream&, const std::string& path,
+               std::map<std::string, std::string>&);
+    bool lookup(const std::string&, std::string*) const;
+
+    size_t register_param(const std::string&);
+    void install(std::shared_ptr<const ConfigSnapshot>);
+    void publish();
+    void reload_file(const std::string& path);
+    void try_reload(const std::string& path);
+
+    //! Last snapshot read by a thread.
+    struct SnapshotCache
+    {
+        uint64_t version = 0;
+        std::shared_ptr<const ConfigSnapshot> snapshot;
+    };
+    void refresh(SnapshotCache&) const;
+
+    //! Current snapshot: a single atomic load, unless it changed since
+    //! the calling thread last read it.
+    const ConfigSnapshot& snapshot() const
+    {
+        thread_local SnapshotCache cache;
+        if (cache.version != _version.load(std::memory_order_acquire))
+            refresh(cache);
+        return *cache.snapshot;
+    }
+    void watch_loop(std::string path, std::promise<void> ready);
 
 public:
-    //! constructor
-    ~Config();
     //! destructor
+    virtual ~Config();
+    //! constructor
     Config();
+    Config(const Config&) = delete;
+    Config& operator=(const Config&) = delete;
 
     //! Returns a new Config instance.
     static Config* createInstance(void);
@@ -81,9 +178,9 @@ public:
     void set(const std::string &parameter_name, const std::string &parameter_value);
 
     //! Return current value of a given parameter.
-    const std::string& get(const std::string &, const std::string& = "") const;
+    std::string get(const std::string &, const std::string& = "") const;
     //! Return current value of a given parameter.
-    const std::string& operator[](const std::string &) const;
+    std::string operator[](const std::string &) const;
 
     //! Return current value of a given parameter as an integer.
     int get_int(const std::string &, int = 0) const;
@@ -99,8 +196,86 @@ public:
 
     //! Dump all configuration parameters to a string.
     std::string to_string() const;
+
+    //! Return a typed, lock-free handle on the given parameter.
+    template<typename T>
+    ConfigParam<T> param(const std::string& name, const T& dfl = T())
+    {
+        return ConfigParam<T>(this, name, register_param(name), dfl);
+    }
+
+    //! Re-read the file found by the last load() and publish it.
+    /**
+     * The new values are parsed into a scratch table first; if the
+     * file is missing or invalid, an exception is thrown and the
+     * current configuration is left untouched.
+     */
+    void reload();
+
+    //! Watch the loaded config file and reload() it on change.
+    /**
+     * Uses inotify on Linux, and polls the modification time
+     * elsewhere. Reload errors are logged and otherwise ignored.
+     */
+    void watch();
+
+    //! Stop watching the config file.
+    void unwatch();
+
+    //! Signal emitted when a registered parameter changes.
+    ChangeSignal& changed() { return _changed; }
+};
+
+//! Typed, cached handle on a configuration parameter.
+/**
+ * Reads do not lock, unless the configuration changed since the
+ * thread last read it: the handle returns the value parsed when the
+ * current snapshot was published. A
+ * value that does not parse as T throws InvalidParamException on
+ * read, just like the corresponding Config::get_xxx() call.
+ *
+ * Supported types are int, long, double, bool and std::string.
+ */
+template<typename T>
+class ConfigParam
+{
+    const Config* _config;
+    std::string _name;
+    size_t _slot;
+    T _default;
+
+    static T cast(const ConfigValue&, const std::string&);
+
+public:
+    ConfigParam(const Config* cfg, const std::string& name,
+                size_t slot, const T& dfl)
+        : _config(cfg), _name(name), _slot(slot), _default(dfl) {}
+
+    const std::string& name() const { return _name; }
+
+    //! Return true if the parameter is currently set.
+    bool has() const
+    {
+        return _config->snapshot().values[_slot].present;
+    }
+
+    //! Return the current value, or the default if not set.
+    T get() const
+    {
+        const ConfigValue& v = _config->snapshot().values[_slot];
+        if (not v.present) return _default;
+        return cast(v, _name);
+    }
+
+    operator T() const { return get(); }
 };
 
+template<> int ConfigParam<int>::cast(const ConfigValue&, const std::string&);
+template<> long ConfigParam<long>::cast(const ConfigValue&, const std::string&);
+template<> double ConfigParam<double>::cast(const ConfigValue&, const std::string&);
+template<> bool ConfigParam<bool>::cast(const ConfigValue&, const std::string&);
+template<> std::string ConfigParam<std::string>::cast(const ConfigValue&, const std::string&);
+
 //! singleton instance (following meyer's design pattern)
 /**
  * Nil: if overwrite is true then the static variable instance@n
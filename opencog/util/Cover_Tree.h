@@ -29,7 +29,7 @@
 #include <cmath>
 #include <iostream>
 #include <map>
-#include <set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -89,9 +89,13 @@
  * your equality operator always return true when distance is 0.
  *
  */
+template<class Point> class FlatCoverTree;
+
 template<class Point>
 class CoverTree
 {
+    friend class FlatCoverTree<Point>;
+
     /**
      * Cover tree node. Consists of arbitrarily many points P, as long as
      * they have distance 0 to each other. Keeps track of its children.
@@ -99,11 +103,20 @@ class CoverTree
     class CoverTreeNode
     {
     private:
-        //_childMap[i] is a vector of the node's children at level i
-        std::map<int,std::vector<CoverTreeNode*> > _childMap;
+        //_children holds all of the node's children, grouped by level,
+        //from the highest level to the lowest. _levels[j] is a level
+        //and the index in _children of the first child at that level.
+        std::vector<CoverTreeNode*> _children;
+        std::vector<std::pair<int,unsigned int> > _levels;
         //_points is all of the points with distance 0 which are not equal.
         std::vector<Point> _points;
+
+        //index in _levels of level, or of where it would go
+        unsigned int find_level(int level) const;
+        unsigned int level_end(unsigned int j) const;
     public:
+        typedef CoverTreeNode* const* child_iterator;
+
         CoverTreeNode(const Point& p);
         /**
          * Returns the children of the node at level i. Note that this means
@@ -113,6 +126,17 @@ class CoverTree
          * has itself as a child in a cover tree.
          */
         std::vector<CoverTreeNode*> get_children(int level) const;
+        /**
+         * Same as above, without copying: the children are in
+         * [first, second).
+         */
+        std::pair<child_iterator,child_iterator> children(int level) const;
+        /**
+         * Number of levels the node has children at, and the jth of
+         * them, from the highest.
+         */
+        unsigned int num_levels() const { return _levels.size(); }
+        int level_at(unsigned int j) const { return _levels[j].first; }
         void add_child(int level, CoverTreeNode* p);
         void remove_child(int level, CoverTreeNode* p);
         void add_point(const Point& p);
@@ -135,20 +159,51 @@ class CoverTree
  private:
     typedef std::pair<double, CoverTreeNode*> distNodePair;
 
+    /**
+     * Buffers reused by the queries of a thread, so that after the
+     * first few, queries allocate no memory.
+     */
+    struct scratch {
+        std::vector<distNodePair> Qi, Qj, heap;
+    };
+    static scratch& thread_scratch();
+
     CoverTreeNode* _root;
     unsigned int _numNodes;
     int _maxLevel;//base^_maxLevel should be the max distance
                   //between any 2 points
     int _minLevel;//A level beneath which there are no more new nodes.
 
-    std::vector<CoverTreeNode*>
-        k_nearest_nodes(const Point& p, const unsigned int& k) const;
     /**
-     * Recursive implementation of the insert algorithm (see paper).
+     * Set heap to the k nearest nodes to p, with their distance,
+     * nearest first. Qj is used as a buffer.
      */
-    bool insert_rec(const Point& p,
-                    const std::vector<distNodePair>& Qi,
-                    const int& level);
+    void k_nearest_nodes(const Point& p, const unsigned int& k,
+                         std::vector<distNodePair>& heap,
+                         std::vector<distNodePair>& Qj) const;
+
+    /**
+     * Where insert puts a point: into dup, an existing node with
+     * distance 0 to it, or else in a new node, child of parent at
+     * level. Both are NULL if the point cannot be inserted (if it is
+     * farther than maxDist from the root).
+     */
+    struct insertPlan {
+        CoverTreeNode* dup;
+        CoverTreeNode* parent;
+        int level;
+    };
+
+    /**
+     * Iterative implementation of the insert algorithm (see paper).
+     * Does not modify the tree, so it can run in several threads.
+     */
+    insertPlan plan_insert(const Point& p) const;
+
+    /**
+     * Carry out plan. Returns the node created, if any.
+     */
+    CoverTreeNode* apply_insert(const Point& p, const insertPlan& plan);
 
     /**
      * Finds the node in Q with the minimum distance to p. Returns a
@@ -163,6 +218,27 @@ class CoverTree
                     int level,
                     bool& multi);
 
+    /**
+     * radii[q][j] is the largest distance from q to the points of its
+     * children at its levels j and below, and of their descendants.
+     */
+    typedef std::unordered_map<const CoverTreeNode*, std::vector<double> >
+        radiusMap;
+    static double subtree_radii(CoverTreeNode* q, radiusMap& radii);
+
+    /**
+     * Dual-tree search of the nearest neighbors of the points of q
+     * and of its children at its levels j and below. R holds the
+     * nodes of this tree whose subtrees may contain them, with their
+     * distance to q, and whose children at level and above have been
+     * visited. If self, q belongs to this tree and its points are
+     * not their own neighbors.
+     */
+    void all_nearest_rec(CoverTreeNode* q, unsigned int j,
+                         std::vector<distNodePair>& R, int level, bool self,
+                         const radiusMap& radii,
+                         std::vector<std::pair<Point,Point> >& out) const;
+
  public:
     const double base;
 
@@ -197,6 +273,19 @@ class CoverTree
      */
     void insert(const Point& newPoint);
 
+    /**
+     * Insert all points, in order; this builds the same tree as calling
+     * insert on each of them, but faster.
+     *
+     * Points are taken by blocks. Where each point of a block goes is
+     * worked out in parallel (with OpenMP), against the tree as it was
+     * before the block, then the points are inserted one by one. A
+     * point within reach of a node created earlier in the same block
+     * (closer to it than base^level, its level) is planned again, so
+     * the result does not depend on the blocks.
+     */
+    void insert_batch(const std::vector<Point>& points);
+
     /**
      * Remove point p from the cover tree. If p is not present in the tree,
      * it will remain unchanged. Otherwise, this will remove exactly one
@@ -211,6 +300,47 @@ class CoverTree
      */
     std::vector<Point> k_nearest_neighbors(const Point& p, const unsigned int& k) const;
 
+    /**
+     * Same as above, but sets out to pointers to the points, which
+     * remain valid until the tree is modified. Once out and the
+     * buffers of the thread have grown enough, this allocates no
+     * memory.
+     */
+    void k_nearest_neighbors(const Point& p, const unsigned int& k,
+                             std::vector<const Point*>& out) const;
+
+    /**
+     * Returns the k nearest neighbors of each point of points, as
+     * above. The queries are run in parallel (with OpenMP).
+     */
+    std::vector<std::vector<Point> >
+        k_nearest_neighbors_batch(const std::vector<Point>& points,
+                                  const unsigned int& k) const;
+
+    /**
+     * Returns the points at distance r or less from p, nearest first.
+     */
+    std::vector<Point> within_radius(const Point& p, const double& r) const;
+
+    /**
+     * Returns each point of queries paired with its nearest neighbor
+     * in the tree, in no particular order. Ties are broken
+     * arbitrarily.
+     *
+     * The queries are searched together, by walking both trees at
+     * once: points close to each other in queries share the work of
+     * narrowing down their candidate neighbors.
+     */
+    std::vector<std::pair<Point,Point> >
+        all_nearest_neighbors(const CoverTree<Point>& queries) const;
+
+    /**
+     * Same as above, for each point of the tree and its nearest
+     * neighbor among the other points. Points alone in the tree have
+     * none, and are left out.
+     */
+    std::vector<std::pair<Point,Point> > all_nearest_neighbors() const;
+
     CoverTreeNode* get_root() const;
 
     /**
@@ -227,10 +357,7 @@ CoverTree<Point>::CoverTree(const double& maxDist,
     _numNodes=0;
     _maxLevel=ceilf(log(maxDist)/log(base));
     _minLevel=_maxLevel-1;
-    typename std::vector<Point>::const_iterator it;
-    for(it=points.begin(); it!=points.end(); ++it) {
-        this->insert(*it);
-    }
+    insert_batch(points);
 }
 
 template<class Point>
@@ -253,35 +380,45 @@ CoverTree<Point>::~CoverTree()
 }
 
 template<class Point>
-std::vector<typename CoverTree<Point>::CoverTreeNode*>
-CoverTree<Point>::k_nearest_nodes(const Point& p, const unsigned int& k) const
+typename CoverTree<Point>::scratch& CoverTree<Point>::thread_scratch()
 {
-    if(_root==NULL) return std::vector<CoverTreeNode*>();
+    static thread_local scratch s;
+    return s;
+}
+
+template<class Point>
+void CoverTree<Point>::k_nearest_nodes(const Point& p, const unsigned int& k,
+                                       std::vector<distNodePair>& heap,
+                                       std::vector<distNodePair>& Qj) const
+{
+    heap.clear();
+    Qj.clear();
+    if(_root==NULL) return;
     //maxDist is the kth nearest known point to p, and also the farthest
-    //point from p in the set minNodes defined below.
+    //point from p in heap.
     double maxDist = p.distance(_root->get_point());
-    //minNodes stores the k nearest known points to p.
-    std::set<distNodePair> minNodes;
-
-    minNodes.insert(std::make_pair(maxDist,_root));
-    std::vector<distNodePair> Qj(1,std::make_pair(maxDist,_root));
+    //heap is a max-heap of the k nearest known points to p.
+    heap.push_back(std::make_pair(maxDist,_root));
+    Qj.push_back(std::make_pair(maxDist,_root));
     for(int level = _maxLevel; level>=_minLevel;level--) {
-        typename std::vector<distNodePair>::const_iterator it;
         int size = Qj.size();
         for(int i=0; i<size; i++) {
-            std::vector<CoverTreeNode*> children =
-                Qj[i].second->get_children(level);
-            typename std::vector<CoverTreeNode*>::const_iterator it2;
-            for(it2=children.begin(); it2!=children.end(); ++it2) {
-                double d = p.distance((*it2)->get_point());
-                if(d < maxDist || minNodes.size() < k) {
-                    minNodes.insert(std::make_pair(d,*it2));
-                    //--minNodes.end() gives us an iterator to the greatest
-                    //element of minNodes.
-                    if(minNodes.size() > k) minNodes.erase(--minNodes.end());
-                    maxDist = (--minNodes.end())->first;
+            std::pair<typename CoverTreeNode::child_iterator,
+                      typename CoverTreeNode::child_iterator>
+                children = Qj[i].second->children(level);
+            for(; children.first!=children.second; ++children.first) {
+                CoverTreeNode* c = *children.first;
+                double d = p.distance(c->get_point());
+                if(d < maxDist || heap.size() < k) {
+                    heap.push_back(std::make_pair(d,c));
+                    std::push_heap(heap.begin(), heap.end());
+                    if(heap.size() > k) {
+                        std::pop_heap(heap.begin(), heap.end());
+                        heap.pop_back();
+                    }
+                    maxDist = heap.front().first;
                 }
-                Qj.push_back(std::make_pair(d,*it2));
+                Qj.push_back(std::make_pair(d,c));
             }
         }
         double sep = maxDist + pow(base, level);
@@ -295,54 +432,86 @@ CoverTree<Point>::k_nearest_nodes(const Point& p, const unsigned int& k) const
             }
         }
     }
-    std::vector<CoverTreeNode*> kNN;
-    typename std::set<distNodePair>::const_iterator it;
-    for(it=minNodes.begin();it!=minNodes.end();++it) {
-        kNN.push_back(it->second);
-    }
-    return kNN;
+    std::sort_heap(heap.begin(), heap.end());
 }
+
 template<class Point>
-bool CoverTree<Point>::insert_rec(const Point& p,
-                                  const std::vector<distNodePair>& Qi,
-                                  const int& level)
+typename CoverTree<Point>::insertPlan
+CoverTree<Point>::plan_insert(const Point& p) const
 {
-    std::vector<std::pair<double, CoverTreeNode*> > Qj;
-    double sep = pow(base,level);
-    double minDist = DBL_MAX;
-    std::pair<double,CoverTreeNode*> minQiDist(DBL_MAX,NULL);
-    typename  std::vector<std::pair<double, CoverTreeNode*> >::const_iterator it;
-    for(it=Qi.begin(); it!=Qi.end(); ++it) {
-        if(it->first<minQiDist.first) minQiDist = *it;
-        if(it->first<minDist) minDist=it->first;
-        if(it->first<=sep) Qj.push_back(*it);
-        std::vector<CoverTreeNode*> children = it->second->get_children(level);
-        typename std::vector<CoverTreeNode*>::const_iterator it2;
-        for(it2=children.begin();it2!=children.end();++it2) {
-            double d = p.distance((*it2)->get_point());
-            if(d<minDist) minDist = d;
-            if(d<=sep) {
-                Qj.push_back(std::make_pair(d,*it2));
+    insertPlan plan = {NULL, NULL, 0};
+    if(_root==NULL) return plan;
+    scratch& buf = thread_scratch();
+    //TODO: this is pretty inefficient, there may be a better way
+    //to check if the node already exists...
+    k_nearest_nodes(p,1,buf.heap,buf.Qj);
+    if(buf.heap[0].first==0.0) {
+        plan.dup = buf.heap[0].second;
+        return plan;
+    }
+    //What follows acts under the assumption that there are no nodes with
+    //distance 0 to p in the cover tree (the previous lines check it).
+    //minQi[i] is the node of Qi nearest to p at level _maxLevel-i.
+    std::vector<distNodePair>& Qi = buf.Qi;
+    std::vector<distNodePair>& Qj = buf.Qj;
+    std::vector<distNodePair>& minQi = buf.heap;
+    Qi.assign(1,std::make_pair(_root->distance(p),_root));
+    minQi.clear();
+    for(int level=_maxLevel;;level--) {
+        double sep = pow(base,level);
+        double minDist = DBL_MAX;
+        distNodePair minQiDist(DBL_MAX,NULL);
+        Qj.clear();
+        typename std::vector<distNodePair>::const_iterator it;
+        for(it=Qi.begin(); it!=Qi.end(); ++it) {
+            if(it->first<minQiDist.first) minQiDist = *it;
+            if(it->first<minDist) minDist=it->first;
+            if(it->first<=sep) Qj.push_back(*it);
+            std::pair<typename CoverTreeNode::child_iterator,
+                      typename CoverTreeNode::child_iterator>
+                children = it->second->children(level);
+            for(; children.first!=children.second; ++children.first) {
+                double d = p.distance((*children.first)->get_point());
+                if(d<minDist) minDist = d;
+                if(d<=sep) {
+                    Qj.push_back(std::make_pair(d,*children.first));
+                }
             }
         }
-    }
-    //std::cout << "level: " << level << ", sep: " << sep << ", dist: " << minQDist.first << "\n";
-    if(minDist > sep) {
-        return true;
-    } else {
-        bool found = insert_rec(p,Qj,level-1);
-        //distNodePair minQiDist = distance(p,Qi);
-        if(found && minQiDist.first <= sep) {
-            if(level-1<_minLevel) _minLevel=level-1;
-            minQiDist.second->add_child(level, new CoverTreeNode(p));
-            //std::cout << "parent is ";
-            //minQiDist.second->get_point().print();
-            _numNodes++;
-            return false;
-        } else {
-            return found;
+        minQi.push_back(minQiDist);
+        if(minDist > sep) {
+            //p goes to the lowest level above this one where the
+            //nearest node of Qi covers it.
+            for(int i=minQi.size()-2; i>=0; i--) {
+                int l = _maxLevel-i;
+                if(minQi[i].first <= pow(base,l)) {
+                    plan.parent = minQi[i].second;
+                    plan.level = l;
+                    break;
+                }
+            }
+            return plan;
         }
+        Qi.swap(Qj);
+    }
+}
+
+template<class Point>
+typename CoverTree<Point>::CoverTreeNode*
+CoverTree<Point>::apply_insert(const Point& p, const insertPlan& plan)
+{
+    if(plan.dup!=NULL) {
+        plan.dup->add_point(p);
+        return NULL;
     }
+    if(plan.parent==NULL) return NULL;
+    if(plan.level-1<_minLevel) _minLevel=plan.level-1;
+    CoverTreeNode* n = new CoverTreeNode(p);
+    plan.parent->add_child(plan.level, n);
+    //std::cout << "parent is ";
+    //plan.parent->get_point().print();
+    _numNodes++;
+    return n;
 }
 
 template<class Point>
@@ -478,18 +647,36 @@ void CoverTree<Point>::insert(const Point& newPoint)
         _numNodes=1;
         return;
     }
-    //TODO: this is pretty inefficient, there may be a better way
-    //to check if the node already exists...
-    CoverTreeNode* n = k_nearest_nodes(newPoint,1)[0];
-    if(newPoint.distance(n->get_point())==0.0) {
-        n->add_point(newPoint);
-    } else {
-        //insert_rec acts under the assumption that there are no nodes with
-        //distance 0 to newPoint in the cover tree (the previous lines check it)
-        insert_rec(newPoint,
-                   std::vector<distNodePair>
-                   (1,std::make_pair(_root->distance(newPoint),_root)),
-                   _maxLevel);
+    apply_insert(newPoint, plan_insert(newPoint));
+}
+
+template<class Point>
+void CoverTree<Point>::insert_batch(const std::vector<Point>& points)
+{
+    const size_t block = 64;
+    size_t i = 0;
+    if(_root==NULL && !points.empty()) insert(points[i++]);
+    std::vector<insertPlan> plans(block);
+    //nodes created in the current block, with their level
+    std::vector<std::pair<CoverTreeNode*,int> > added;
+    for(; i<points.size(); i+=block) {
+        size_t n = std::min(block, points.size()-i);
+        #pragma omp parallel for schedule(dynamic)
+        for(size_t j=0; j<n; j++)
+            plans[j] = plan_insert(points[i+j]);
+        added.clear();
+        for(size_t j=0; j<n; j++) {
+            const Point& p = points[i+j];
+            typename std::vector<std::pair<CoverTreeNode*,int> >::const_iterator it;
+            for(it=added.begin(); it!=added.end(); ++it) {
+                if(p.distance(it->first->get_point()) <= pow(base,it->second)) {
+                    plans[j] = plan_insert(p);
+                    break;
+                }
+            }
+            CoverTreeNode* node = apply_insert(p, plans[j]);
+            if(node!=NULL) added.push_back(std::make_pair(node,plans[j].level));
+        }
     }
 }
 
@@ -539,17 +726,218 @@ std::vector<Point> CoverTree<Point>::k_nearest_neighbors(const Point& p,
                                                          const unsigned int& k) const
 {
     if(_root==NULL) return std::vector<Point>();
-    std::vector<CoverTreeNode*> v = k_nearest_nodes(p, k);
+    scratch& buf = thread_scratch();
+    k_nearest_nodes(p, k, buf.heap, buf.Qj);
     std::vector<Point> kNN;
-    typename std::vector<CoverTreeNode*>::const_iterator it;
-    for(it=v.begin();it!=v.end();++it) {
-        const std::vector<Point>& p = (*it)->get_points();
+    typename std::vector<distNodePair>::const_iterator it;
+    for(it=buf.heap.begin();it!=buf.heap.end();++it) {
+        const std::vector<Point>& p = it->second->get_points();
         kNN.insert(kNN.end(),p.begin(),p.end());
         if(kNN.size() >= k) break;
     }
     return kNN;
 }
 
+template<class Point>
+void CoverTree<Point>::k_nearest_neighbors(const Point& p,
+                                           const unsigned int& k,
+                                           std::vector<const Point*>& out) const
+{
+    out.clear();
+    if(_root==NULL) return;
+    scratch& buf = thread_scratch();
+    k_nearest_nodes(p, k, buf.heap, buf.Qj);
+    typename std::vector<distNodePair>::const_iterator it;
+    for(it=buf.heap.begin();it!=buf.heap.end();++it) {
+        const std::vector<Point>& p = it->second->get_points();
+        for(unsigned int i=0;i<p.size();i++) out.push_back(&p[i]);
+        if(out.size() >= k) break;
+    }
+}
+
+template<class Point>
+std::vector<std::vector<Point> >
+CoverTree<Point>::k_nearest_neighbors_batch(const std::vector<Point>& points,
+                                            const unsigned int& k) const
+{
+    std::vector<std::vector<Point> > res(points.size());
+    #pragma omp parallel for schedule(dynamic, 16)
+    for(size_t i=0; i<points.size(); i++)
+        res[i] = k_nearest_neighbors(points[i], k);
+    return res;
+}
+
+template<class Point>
+std::vector<Point> CoverTree<Point>::within_radius(const Point& p,
+                                                  const double& r) const
+{
+    std::vector<Point> res;
+    if(_root==NULL) return res;
+    std::vector<distNodePair>& Qj = thread_scratch().Qj;
+    Qj.assign(1,std::make_pair(p.distance(_root->get_point()),_root));
+    for(int level = _maxLevel; level>=_minLevel; level--) {
+        int size = Qj.size();
+        for(int i=0; i<size; i++) {
+            std::pair<typename CoverTreeNode::child_iterator,
+                      typename CoverTreeNode::child_iterator>
+                children = Qj[i].second->children(level);
+            for(; children.first!=children.second; ++children.first) {
+                CoverTreeNode* c = *children.first;
+                Qj.push_back(std::make_pair(p.distance(c->get_point()),c));
+            }
+        }
+        //the descendants of the nodes of Qj are within base^level of them
+        double sep = r + pow(base, level);
+        size = Qj.size();
+        for(int i=0; i<size; i++) {
+            if(Qj[i].first > sep) {
+                Qj[i]=Qj.back();
+                Qj.pop_back();
+                size--; i--;
+            }
+        }
+    }
+    std::sort(Qj.begin(), Qj.end());
+    typename std::vector<distNodePair>::const_iterator it;
+    for(it=Qj.begin();it!=Qj.end() && it->first<=r;++it) {
+        const std::vector<Point>& p = it->second->get_points();
+        res.insert(res.end(),p.begin(),p.end());
+    }
+    return res;
+}
+
+template<class Point>
+double CoverTree<Point>::subtree_radii(CoverTreeNode* q, radiusMap& radii)
+{
+    std::vector<double>& r = radii[q];
+    r.assign(q->num_levels(), 0.0);
+    for(int j=q->num_levels()-1; j>=0; j--) {
+        double rj = j+1<(int)q->num_levels() ? r[j+1] : 0.0;
+        std::pair<typename CoverTreeNode::child_iterator,
+                  typename CoverTreeNode::child_iterator>
+            children = q->children(q->level_at(j));
+        for(; children.first!=children.second; ++children.first) {
+            CoverTreeNode* c = *children.first;
+            rj = std::max(rj, q->distance(*c) + subtree_radii(c, radii));
+        }
+        r[j] = rj;
+    }
+    return r.empty() ? 0.0 : r[0];
+}
+
+template<class Point>
+void CoverTree<Point>::all_nearest_rec(CoverTreeNode* q, unsigned int j,
+                                       std::vector<distNodePair>& R,
+                                       int level, bool self,
+                                       const radiusMap& radii,
+                                       std::vector<std::pair<Point,Point> >& out) const
+{
+    while(true) {
+        //the points of q and of its children at its levels j and below
+        //are within rho of q
+        double rho = j<q->num_levels() ? radii.at(q)[j] : 0.0;
+        //refine the candidates while they are coarse compared to q
+        //(4*rho was found to be about best), then split q
+        if(level>=_minLevel && (j==q->num_levels() || pow(base,level)>=4*rho)) {
+            int size = R.size();
+            for(int i=0; i<size; i++) {
+                std::pair<typename CoverTreeNode::child_iterator,
+                          typename CoverTreeNode::child_iterator>
+                    children = R[i].second->children(level);
+                for(; children.first!=children.second; ++children.first) {
+                    CoverTreeNode* c = *children.first;
+                    R.push_back(std::make_pair(q->distance(*c),c));
+                }
+            }
+            //any point of q has a neighbor within minDist+rho of it. If
+            //self, one of the two nearest nodes may be the point itself.
+            double min1 = DBL_MAX, min2 = DBL_MAX;
+            typename std::vector<distNodePair>::const_iterator it;
+            for(it=R.begin();it!=R.end();++it) {
+                if(it->first<min1) {
+                    min2 = min1;
+                    min1 = it->first;
+                } else if(it->first<min2) min2 = it->first;
+            }
+            double minDist = self ? min2 : min1;
+            double sep = minDist + 2*rho + pow(base, level);
+            size = R.size();
+            for(int i=0; i<size; i++) {
+                if(R[i].first > sep) {
+                    R[i]=R.back();
+                    R.pop_back();
+                    size--; i--;
+                }
+            }
+            level--;
+        } else if(j<q->num_levels()) {
+            //split q: search its children at its jth level on their own
+            std::pair<typename CoverTreeNode::child_iterator,
+                      typename CoverTreeNode::child_iterator>
+                children = q->children(q->level_at(j));
+            for(; children.first!=children.second; ++children.first) {
+                CoverTreeNode* c = *children.first;
+                std::vector<distNodePair> Rc;
+                Rc.reserve(R.size());
+                typename std::vector<distNodePair>::const_iterator it;
+                for(it=R.begin();it!=R.end();++it)
+                    Rc.push_back(std::make_pair(c->distance(*it->second),
+                                                it->second));
+                all_nearest_rec(c, 0, Rc, level, self, radii, out);
+            }
+            j++;
+        } else break;
+    }
+    //R now holds every point that may be nearest to q
+    const std::vector<Point>& qp = q->get_points();
+    for(unsigned int i=0; i<qp.size(); i++) {
+        double minDist = DBL_MAX;
+        const Point* nearest = NULL;
+        typename std::vector<distNodePair>::const_iterator it;
+        for(it=R.begin();it!=R.end();++it) {
+            if(!(it->first<minDist)) continue;
+            const std::vector<Point>& rp = it->second->get_points();
+            if(self && it->second==q) {
+                if(rp.size()>1) {
+                    minDist = 0.0;
+                    nearest = &rp[i==0 ? 1 : 0];
+                }
+            } else {
+                minDist = it->first;
+                nearest = &rp[0];
+            }
+        }
+        if(nearest!=NULL) out.push_back(std::make_pair(qp[i],*nearest));
+    }
+}
+
+template<class Point>
+std::vector<std::pair<Point,Point> >
+CoverTree<Point>::all_nearest_neighbors(const CoverTree<Point>& queries) const
+{
+    std::vector<std::pair<Point,Point> > res;
+    if(_root==NULL || queries._root==NULL) return res;
+    std::vector<distNodePair>
+        R(1,std::make_pair(queries._root->distance(*_root),_root));
+    radiusMap radii;
+    subtree_radii(queries._root, radii);
+    all_nearest_rec(queries._root, 0, R, _maxLevel, false, radii, res);
+    return res;
+}
+
+template<class Point>
+std::vector<std::pair<Point,Point> >
+CoverTree<Point>::all_nearest_neighbors() const
+{
+    std::vector<std::pair<Point,Point> > res;
+    if(_root==NULL) return res;
+    std::vector<distNodePair> R(1,std::make_pair(0.0,_root));
+    radiusMap radii;
+    subtree_radii(_root, radii);
+    all_nearest_rec(_root, 0, R, _maxLevel, true, radii, res);
+    return res;
+}
+
 template<class Point>
 void CoverTree<Point>::print() const
 {
@@ -591,32 +979,64 @@ CoverTree<Point>::CoverTreeNode::CoverTreeNode(const Point& p) {
     _points.push_back(p);
 }
 
+template<class Point>
+unsigned int CoverTree<Point>::CoverTreeNode::find_level(int level) const
+{
+    unsigned int j=0;
+    while(j<_levels.size() && _levels[j].first>level) j++;
+    return j;
+}
+
+template<class Point>
+unsigned int CoverTree<Point>::CoverTreeNode::level_end(unsigned int j) const
+{
+    return j+1<_levels.size() ? _levels[j+1].second : _children.size();
+}
+
+template<class Point>
+std::pair<typename CoverTree<Point>::CoverTreeNode::child_iterator,
+          typename CoverTree<Point>::CoverTreeNode::child_iterator>
+CoverTree<Point>::CoverTreeNode::children(int level) const
+{
+    unsigned int j = find_level(level);
+    if(j==_levels.size() || _levels[j].first!=level)
+        return std::make_pair(child_iterator(NULL),child_iterator(NULL));
+    child_iterator c = _children.data();
+    return std::make_pair(c+_levels[j].second, c+level_end(j));
+}
+
 template<class Point>
 std::vector<typename CoverTree<Point>::CoverTreeNode*>
 CoverTree<Point>::CoverTreeNode::get_children(int level) const
 {
-    typename std::map<int,std::vector<CoverTreeNode*> >::const_iterator
-        it = _childMap.find(level);
-    if(it!=_childMap.end()) {
-        return it->second;
-    }
-    return std::vector<CoverTreeNode*>();
+    std::pair<child_iterator,child_iterator> c = children(level);
+    return std::vector<CoverTreeNode*>(c.first, c.second);
 }
 
 template<class Point>
 void CoverTree<Point>::CoverTreeNode::add_child(int level, CoverTreeNode* p)
 {
-    _childMap[level].push_back(p);
+    unsigned int j = find_level(level);
+    if(j==_levels.size() || _levels[j].first!=level)
+        _levels.insert(_levels.begin()+j,
+                       std::make_pair(level,(unsigned int)(j<_levels.size() ?
+                                      _levels[j].second : _children.size())));
+    _children.insert(_children.begin()+level_end(j), p);
+    for(unsigned int l=j+1;l<_levels.size();l++) _levels[l].second++;
 }
 
 template<class Point>
 void CoverTree<Point>::CoverTreeNode::remove_child(int level, CoverTreeNode* p)
 {
-    std::vector<CoverTreeNode*>& v = _childMap[level];
-    for(unsigned int i=0;i<v.size();i++) {
-        if(v[i]==p) {
-            v[i]=v.back();
-            v.pop_back();
+    unsigned int j = find_level(level);
+    if(j==_levels.size() || _levels[j].first!=level) return;
+    unsigned int end = level_end(j);
+    for(unsigned int i=_levels[j].second;i<end;i++) {
+        if(_children[i]==p) {
+            _children[i]=_children[end-1];
+            _children.erase(_children.begin()+end-1);
+            for(unsigned int l=j+1;l<_levels.size();l++) _levels[l].second--;
+            if(_levels[j].second==end-1) _levels.erase(_levels.begin()+j);
             break;
         }
     }
@@ -663,12 +1083,7 @@ template<class Point>
 std::vector<typename CoverTree<Point>::CoverTreeNode*>
 CoverTree<Point>::CoverTreeNode::get_all_children() const
 {
-    std::vector<CoverTreeNode*> children;
-    typename std::map<int,std::vector<CoverTreeNode*> >::const_iterator it;
-    for(it=_childMap.begin();it!=_childMap.end();++it) {
-        children.insert(children.end(), it->second.begin(), it->second.end());
-    }
-    return children;
+    return _children;
 }
 
 template<class Point>
@@ -0,0 +1,504 @@
+/*
+ * opencog/util/Flat_Cover_Tree.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _FLAT_COVER_TREE_H
+#define _FLAT_COVER_TREE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <opencog/util/Cover_Tree.h>
+#include <opencog/util/exceptions.h>
+#include <opencog/util/oc_assert.h>
+
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+//! Read-only, compact copy of a CoverTree, which can be saved to a file.
+/**
+ * The nodes are laid out breadth first in one array, so that the
+ * children of a node are contiguous, grouped by level from the highest
+ * to the lowest; a node only keeps the range of its points and of its
+ * levels, and each level the range of its children. The points are in
+ * one array as well. k_nearest_neighbors and within_radius give the
+ * same results as those of the CoverTree it was built from.
+ *
+ * save() writes these arrays as they are to a file, which the file
+ * constructor maps into memory (on POSIX systems, it reads it
+ * elsewhere): a saved index loads without any work but checking its
+ * header, and its pages are read from disk as queries touch them, and
+ * shared by all the processes using it. For that, Point must be
+ * trivially copyable (no pointers, std::vector...). Files are only
+ * readable on machines of the same endianness.
+ */
+template<class Point>
+class FlatCoverTree
+{
+public:
+    /**
+     * Copy tree.
+     */
+    explicit FlatCoverTree(const CoverTree<Point>& tree);
+
+    /**
+     * Map the tree saved to filename. Throws an IOException if it
+     * cannot be read, or was not saved by a FlatCoverTree<Point>. The
+     * indices of the nodes are checked once, when mapping.
+     */
+    explicit FlatCoverTree(const std::string& filename);
+
+    ~FlatCoverTree();
+
+    FlatCoverTree(const FlatCoverTree&) = delete;
+    FlatCoverTree& operator=(const FlatCoverTree&) = delete;
+
+    /**
+     * Write the tree to filename. Throws an IOException on failure.
+     */
+    void save(const std::string& filename) const;
+
+    /**
+     * Same as CoverTree::k_nearest_neighbors.
+     */
+    std::vector<Point> k_nearest_neighbors(const Point& p,
+                                           const unsigned int& k) const;
+    void k_nearest_neighbors(const Point& p, const unsigned int& k,
+                             std::vector<const Point*>& out) const;
+
+    /**
+     * Same as CoverTree::within_radius.
+     */
+    std::vector<Point> within_radius(const Point& p, const double& r) const;
+
+    unsigned int num_nodes() const { return _header.n_nodes; }
+    size_t num_points() const { return _header.n_points; }
+
+private:
+    struct fileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t point_size;
+        uint32_t n_nodes;
+        uint32_t n_levels;
+        uint64_t n_points;
+        int32_t max_level;
+        int32_t min_level;
+        double base;
+    };
+    struct flatNode {
+        uint64_t first_point, end_point;
+        uint32_t first_level, end_level;
+    };
+    struct flatLevel {
+        int32_t level;
+        uint32_t first_child, end_child;
+    };
+
+    typedef std::pair<double, uint32_t> distNodePair;
+
+    //node of a cover set, and its next level to visit
+    struct candidate {
+        double dist;
+        uint32_t node;
+        uint32_t level;
+    };
+
+    struct scratch {
+        std::vector<candidate> Qj;
+        std::vector<distNodePair> heap;
+    };
+    static scratch& thread_scratch();
+
+    static const char* magic() { return "OCCOVTR"; }
+    static const uint32_t version = 1;
+
+    //offset in the file of an array after offset bytes, aligned on 8
+    static uint64_t align(uint64_t offset)
+    {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    fileHeader _header;
+    const flatNode* _nodes;
+    const flatLevel* _levels;
+    const Point* _points;
+
+    //storage, when copied from a CoverTree
+    std::vector<flatNode> _nodeBuf;
+    std::vector<flatLevel> _levelBuf;
+    std::vector<Point> _pointBuf;
+
+    //storage, when loaded from a file
+    void* _map;
+    size_t _mapSize;
+    std::vector<uint64_t> _fileBuf;
+
+    //whether the nodes, levels and points indexed by the nodes and
+    //levels are in their arrays, and every node has points, so that
+    //queries stay within a loaded file
+    bool valid_ranges() const;
+
+    const Point& point(uint32_t n) const
+    {
+        return _points[_nodes[n].first_point];
+    }
+
+    candidate make_candidate(double dist, uint32_t n) const
+    {
+        candidate c = {dist, n, _nodes[n].first_level};
+        return c;
+    }
+
+    /**
+     * Add to Qj the children at level of its nodes, calling
+     * visit(distance to p, child) on each.
+     */
+    template<typename Visit>
+    void descend(const Point& p, int level, std::vector<candidate>& Qj,
+                 Visit visit) const;
+
+    //same as CoverTree::k_nearest_nodes
+    void k_nearest_nodes(const Point& p, const unsigned int& k,
+                         std::vector<distNodePair>& heap,
+                         std::vector<candidate>& Qj) const;
+};
+
+template<class Point>
+FlatCoverTree<Point>::FlatCoverTree(const CoverTree<Point>& tree)
+    : _map(NULL), _mapSize(0)
+{
+    typedef typename CoverTree<Point>::CoverTreeNode treeNode;
+    std::memset(&_header, 0, sizeof(_header));
+    std::memcpy(_header.magic, magic(), sizeof(_header.magic));
+    _header.version = version;
+    _header.point_size = sizeof(Point);
+    _header.max_level = tree._maxLevel;
+    _header.min_level = tree._minLevel;
+    _header.base = tree.base;
+
+    //breadth first, so the children of a node, taken level by level,
+    //come one after the other
+    std::vector<treeNode*> order;
+    if(tree._root!=NULL) order.push_back(tree._root);
+    for(size_t i=0; i<order.size(); i++) {
+        treeNode* n = order[i];
+        flatNode fn;
+        const std::vector<Point>& p = n->get_points();
+        fn.first_point = _pointBuf.size();
+        _pointBuf.insert(_pointBuf.end(), p.begin(), p.end());
+        fn.end_point = _pointBuf.size();
+        fn.first_level = _levelBuf.size();
+        for(unsigned int j=0; j<n->num_levels(); j++) {
+            flatLevel fl;
+            fl.level = n->level_at(j);
+            fl.first_child = order.size();
+            std::pair<typename treeNode::child_iterator,
+                      typename treeNode::child_iterator>
+                children = n->children(fl.level);
+            order.insert(order.end(), children.first, children.second);
+            OC_ASSERT(order.size() < UINT32_MAX,
+                      "FlatCoverTree - too many nodes");
+            fl.end_child = order.size();
+            _levelBuf.push_back(fl);
+        }
+        fn.end_level = _levelBuf.size();
+        _nodeBuf.push_back(fn);
+    }
+    _header.n_nodes = _nodeBuf.size();
+    _header.n_levels = _levelBuf.size();
+    _header.n_points = _pointBuf.size();
+    _nodes = _nodeBuf.data();
+    _levels = _levelBuf.data();
+    _points = _pointBuf.data();
+}
+
+template<class Point>
+FlatCoverTree<Point>::FlatCoverTree(const std::string& filename)
+    : _map(NULL), _mapSize(0)
+{
+    static_assert(std::is_trivially_copyable<Point>::value,
+                  "FlatCoverTree files need trivially copyable points");
+    static_assert(alignof(Point) <= 8,
+                  "FlatCoverTree files need points aligned on 8 or less");
+    const char* data = NULL;
+    size_t size = 0;
+#ifndef WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) != 0) {
+        if(fd >= 0) close(fd);
+        throw opencog::IOException(TRACE_INFO,
+            "FlatCoverTree - unable to open file \"%s\"", filename.c_str());
+    }
+    size = st.st_size;
+    if(size > 0) {
+        _map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(_map == MAP_FAILED) {
+            _map = NULL;
+            throw opencog::IOException(TRACE_INFO,
+                "FlatCoverTree - unable to map file \"%s\"", filename.c_str());
+        }
+        _mapSize = size;
+        data = static_cast<const char*>(_map);
+    } else close(fd);
+#else
+    std::ifstream in(filename.c_str(), std::ios::binary | std::ios::ate);
+    if(!in)
+        throw opencog::IOException(TRACE_INFO,
+            "FlatCoverTree - unable to open file \"%s\"", filename.c_str());
+    size = in.tellg();
+    _fileBuf.resize((size + 7) / 8);
+    in.seekg(0);
+    if(!in.read(reinterpret_cast<char*>(_fileBuf.data()), size))
+        throw opencog::IOException(TRACE_INFO,
+            "FlatCoverTree - unable to read file \"%s\"", filename.c_str());
+    data = reinterpret_cast<const char*>(_fileBuf.data());
+#endif
+
+    if(size >= sizeof(_header)) std::memcpy(&_header, data, sizeof(_header));
+    //n_nodes and n_levels are 32 bits, so the offsets cannot overflow,
+    //but n_points is compared to the room left rather than multiplied
+    uint64_t nodes = align(sizeof(_header));
+    uint64_t levels = align(nodes + sizeof(flatNode)
+                            * uint64_t(_header.n_nodes));
+    uint64_t points = align(levels + sizeof(flatLevel)
+                            * uint64_t(_header.n_levels));
+    bool valid = size >= sizeof(_header)
+        && std::memcmp(_header.magic, magic(), sizeof(_header.magic)) == 0
+        && _header.version == version
+        && _header.point_size == sizeof(Point)
+        && points <= size
+        && (size - points) % sizeof(Point) == 0
+        && (size - points) / sizeof(Point) == _header.n_points;
+    if(valid) {
+        _nodes = reinterpret_cast<const flatNode*>(data + nodes);
+        _levels = reinterpret_cast<const flatLevel*>(data + levels);
+        _points = reinterpret_cast<const Point*>(data + points);
+        valid = valid_ranges();
+    }
+    if(!valid) {
+#ifndef WIN32
+        if(_map != NULL) munmap(_map, _mapSize);
+#endif
+        throw opencog::IOException(TRACE_INFO,
+            "FlatCoverTree - \"%s\" is not a saved tree of these points",
+            filename.c_str());
+    }
+}
+
+template<class Point>
+bool FlatCoverTree<Point>::valid_ranges() const
+{
+    for(uint32_t n=0; n<_header.n_nodes; n++) {
+        const flatNode& fn = _nodes[n];
+        if(fn.first_point >= fn.end_point || fn.end_point > _header.n_points
+           || fn.first_level > fn.end_level
+           || fn.end_level > _header.n_levels)
+            return false;
+    }
+    for(uint32_t l=0; l<_header.n_levels; l++) {
+        const flatLevel& fl = _levels[l];
+        if(fl.first_child > fl.end_child || fl.end_child > _header.n_nodes)
+            return false;
+    }
+    return true;
+}
+
+template<class Point>
+FlatCoverTree<Point>::~FlatCoverTree()
+{
+#ifndef WIN32
+    if(_map != NULL) munmap(_map, _mapSize);
+    _map = NULL;
+#endif
+}
+
+template<class Point>
+void FlatCoverTree<Point>::save(const std::string& filename) const
+{
+    static_assert(std::is_trivially_copyable<Point>::value,
+                  "FlatCoverTree files need trivially copyable points");
+    std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+    const char zeros[8] = {0};
+    size_t offset = 0;
+    //write size bytes of data at the next offset aligned on 8
+    auto write = [&](const void* data, size_t size) {
+        out.write(zeros, align(offset) - offset);
+        out.write(static_cast<const char*>(data), size);
+        offset = align(offset) + size;
+    };
+    write(&_header, sizeof(_header));
+    write(_nodes, sizeof(flatNode) * _header.n_nodes);
+    write(_levels, sizeof(flatLevel) * _header.n_levels);
+    write(_points, sizeof(Point) * _header.n_points);
+    out.close();
+    if(!out)
+        throw opencog::IOException(TRACE_INFO,
+            "FlatCoverTree - unable to write file \"%s\"", filename.c_str());
+}
+
+template<class Point>
+typename FlatCoverTree<Point>::scratch& FlatCoverTree<Point>::thread_scratch()
+{
+    static thread_local scratch s;
+    return s;
+}
+
+template<class Point>
+template<typename Visit>
+void FlatCoverTree<Point>::descend(const Point& p, int level,
+                                   std::vector<candidate>& Qj,
+                                   Visit visit) const
+{
+    int size = Qj.size();
+    for(int i=0; i<size; i++) {
+        //the levels of a node decrease, and are all at or below level
+        //once the higher ones have been visited
+        candidate& q = Qj[i];
+        if(q.level==_nodes[q.node].end_level
+           || _levels[q.level].level!=level) continue;
+        const flatLevel& l = _levels[q.level++];
+        for(uint32_t c=l.first_child; c<l.end_child; c++) {
+            double d = p.distance(point(c));
+            visit(d, c);
+            Qj.push_back(make_candidate(d, c));
+        }
+    }
+}
+
+template<class Point>
+void FlatCoverTree<Point>::k_nearest_nodes(const Point& p,
+                                           const unsigned int& k,
+                                           std::vector<distNodePair>& heap,
+                                           std::vector<candidate>& Qj) const
+{
+    heap.clear();
+    Qj.clear();
+    if(_header.n_nodes==0) return;
+    double maxDist = p.distance(point(0));
+    heap.push_back(std::make_pair(maxDist,0u));
+    Qj.push_back(make_candidate(maxDist,0u));
+    for(int level = _header.max_level; level>=_header.min_level; level--) {
+        descend(p, level, Qj, [&](double d, uint32_t c) {
+            if(d < maxDist || heap.size() < k) {
+                heap.push_back(std::make_pair(d,c));
+                std::push_heap(heap.begin(), heap.end());
+                if(heap.size() > k) {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.pop_back();
+                }
+                maxDist = heap.front().first;
+            }
+        });
+        double sep = maxDist + pow(_header.base, level);
+        int size = Qj.size();
+        for(int i=0; i<size; i++) {
+            if(Qj[i].dist > sep) {
+                Qj[i]=Qj.back();
+                Qj.pop_back();
+                size--; i--;
+            }
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end());
+}
+
+template<class Point>
+std::vector<Point> FlatCoverTree<Point>::k_nearest_neighbors(const Point& p,
+                                                             const unsigned int& k) const
+{
+    std::vector<const Point*> out;
+    k_nearest_neighbors(p, k, out);
+    std::vector<Point> kNN;
+    kNN.reserve(out.size());
+    for(size_t i=0; i<out.size(); i++) kNN.push_back(*out[i]);
+    return kNN;
+}
+
+template<class Point>
+void FlatCoverTree<Point>::k_nearest_neighbors(const Point& p,
+                                               const unsigned int& k,
+                                               std::vector<const Point*>& out) const
+{
+    out.clear();
+    scratch& buf = thread_scratch();
+    k_nearest_nodes(p, k, buf.heap, buf.Qj);
+    typename std::vector<distNodePair>::const_iterator it;
+    for(it=buf.heap.begin();it!=buf.heap.end();++it) {
+        const flatNode& n = _nodes[it->second];
+        for(uint64_t i=n.first_point;i<n.end_point;i++)
+            out.push_back(&_points[i]);
+        if(out.size() >= k) break;
+    }
+}
+
+template<class Point>
+std::vector<Point> FlatCoverTree<Point>::within_radius(const Point& p,
+                                                       const double& r) const
+{
+    std::vector<Point> res;
+    if(_header.n_nodes==0) return res;
+    std::vector<candidate>& Qj = thread_scratch().Qj;
+    Qj.assign(1,make_candidate(p.distance(point(0)),0u));
+    for(int level = _header.max_level; level>=_header.min_level; level--) {
+        descend(p, level, Qj, [](double, uint32_t) {});
+        double sep = r + pow(_header.base, level);
+        int size = Qj.size();
+        for(int i=0; i<size; i++) {
+            if(Qj[i].dist > sep) {
+                Qj[i]=Qj.back();
+                Qj.pop_back();
+                size--; i--;
+            }
+        }
+    }
+    std::sort(Qj.begin(), Qj.end(),
+              [](const candidate& a, const candidate& b) {
+                  return a.dist < b.dist;
+              });
+    typename std::vector<candidate>::const_iterator it;
+    for(it=Qj.begin();it!=Qj.end() && it->dist<=r;++it) {
+        const flatNode& n = _nodes[it->node];
+        res.insert(res.end(), _points + n.first_point, _points + n.end_point);
+    }
+    return res;
+}
+
+/** @}*/
+
+#endif // _FLAT_COVER_TREE_H
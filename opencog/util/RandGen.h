@@ -25,6 +25,7 @@
 #ifndef _OPENCOG_RAND_GEN_H
 #define _OPENCOG_RAND_GEN_H
 
+#include <cstdint>
 #include <set>
 #include <vector>
 #include <opencog/util/exceptions.h>
@@ -51,8 +52,63 @@ class RandGen : public std::mt19937
 
 public:
 
+    RandGen() : _legacy_randint(false) {}
+
     virtual ~RandGen() {}
 
+    //! random integer in [0,n), or 0 if n is 0.
+    /**
+     * Unbiased, by Lemire's multiply-shift rejection method: a draw
+     * is multiplied by n and the high half kept, and a division is
+     * only needed on the rare draws that might have to be rejected.
+     */
+    uint32_t randbounded32(uint32_t n)
+    {
+        std::mt19937& engine = *this;
+        uint64_t m = uint64_t(engine()) * n;
+        uint32_t low = uint32_t(m);
+        if (low < n) {
+            uint32_t threshold = uint32_t(-n) % n;
+            while (low < threshold) {
+                m = uint64_t(engine()) * n;
+                low = uint32_t(m);
+            }
+        }
+        return m >> 32;
+    }
+
+    //! random integer in [0,n), or 0 if n is 0; see randbounded32.
+    uint64_t randbounded64(uint64_t n)
+    {
+        if (n <= UINT32_MAX)
+            return randbounded32(n);
+        uint64_t x = draw64();
+#ifdef __SIZEOF_INT128__
+        unsigned __int128 m = (unsigned __int128)x * n;
+        uint64_t low = uint64_t(m);
+        if (low < n) {
+            uint64_t threshold = uint64_t(-n) % n;
+            while (low < threshold) {
+                x = draw64();
+                m = (unsigned __int128)x * n;
+                low = uint64_t(m);
+            }
+        }
+        return m >> 64;
+#else
+        uint64_t threshold = uint64_t(-n) % n;
+        while (x < threshold)
+            x = draw64();
+        return x % n;
+#endif
+    }
+
+    //! Make randint(n) and randbool() draw as they used to, with a
+    //! modulo, so as to reproduce runs made before they were
+    //! unbiased. Off by default.
+    void set_legacy_randint(bool legacy) { _legacy_randint = legacy; }
+    bool legacy_randint() const { return _legacy_randint; }
+
     //! random int between 0 and max rand number.
     virtual int randint() = 0;
 
@@ -76,6 +132,26 @@ public:
 
     //! random discrete base on weights
     virtual int rand_discrete(const std::vector<double>&) = 0;
+
+    //! random discrete from a precomputed sampler, such as
+    //! alias_sampler or fenwick_sampler
+    template<typename Sampler>
+    int rand_discrete(const Sampler& sampler)
+    {
+        return sampler(*this);
+    }
+
+protected:
+    bool _legacy_randint;
+
+    //! 64 random bits, the high half drawn first.
+    uint64_t draw64()
+    {
+        std::mt19937& engine = *this;
+        const uint64_t hi = engine();
+        const uint64_t lo = engine();
+        return (hi << 32) | lo;
+    }
 };
 
 /** @}*/
@@ -1568,6 +1568,66 @@ Otherwise, the distance between two columns in the matrix is calculated.
 
 /* *********************************************************************  */
 
+/**
+ * \internal
+ * A value of each of the two vectors compared by kendall.
+ */
+typedef struct {double x; double y;} xypair;
+
+/* ---------------------------------------------------------------------- */
+
+/**
+ * \internal
+ * Helper function for kendall, to sort pairs by x and then by y.
+ */
+static
+int comparexy(const void* a, const void* b)
+{ const xypair* p1 = (const xypair*)a;
+  const xypair* p2 = (const xypair*)b;
+  if (p1->x < p2->x) return -1;
+  if (p1->x > p2->x) return +1;
+  if (p1->y < p2->y) return -1;
+  if (p1->y > p2->y) return +1;
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+/**
+ * \internal
+ * Sorts the n elements of data by a bottom-up merge sort, using buffer, an
+ * array of n elements, and returns the number of pairs i < j such that
+ * data[i] > data[j] before sorting.
+ */
+static
+double mergeinversions(int n, double data[], double buffer[])
+{ double inversions = 0.;
+  int width;
+  for (width = 1; width < n; width *= 2)
+  { int lo;
+    for (lo = 0; lo < n - width; lo += 2*width)
+    { const int mid = lo + width;
+      const int hi = (n - mid < width) ? n : mid + width;
+      int i = lo;
+      int j = mid;
+      int k = lo;
+      while (i < mid && j < hi)
+      { if (data[j] < data[i])
+        { inversions += mid - i;
+          buffer[k++] = data[j++];
+        }
+        else buffer[k++] = data[i++];
+      }
+      /* The elements left in the second half are already in place */
+      while (i < mid) buffer[k++] = data[i++];
+      memcpy(data+lo, buffer+lo, (j-lo)*sizeof(double));
+    }
+  }
+  return inversions;
+}
+
+/* *********************************************************************  */
+
 static
 double kendall (int n, double** data1, double** data2, int** mask1, int** mask2,
   const double weight[], int index1, int index2, int transpose)
@@ -1616,61 +1676,88 @@ If transpose==0, the distance between two rows in the matrix is calculated.
 Otherwise, the distance between two columns in the matrix is calculated.
 
 */
-{ int con = 0;
-  int dis = 0;
-  int exx = 0;
-  int exy = 0;
-  int flag = 0;
-  /* flag will remain zero if no nonzero combinations of mask1 and mask2 are
-   * found.
+{ int i, j;
+  int m = 0;
+  /* Numbers of pairs: tied in x, in y, in both, and discordant. Pairs
+   * tied in both count in none of con, dis, exx and exy. These are
+   * integers, but kept as doubles since there are m*(m-1)/2 pairs.
    */
+  double tx = 0.;
+  double ty = 0.;
+  double txy = 0.;
+  double total;
+  double con;
+  double dis;
+  double exx;
+  double exy;
   double denomx;
   double denomy;
   double tau;
-  int i, j;
+  xypair* pairs;
+  double* y;
+  pairs = malloc(n*sizeof(xypair));
+  if(!pairs) return 0.0; /* Memory allocation error */
   if (transpose==0)
   { for (i = 0; i < n; i++)
     { if (mask1[index1][i] && mask2[index2][i])
-      { for (j = 0; j < i; j++)
-        { if (mask1[index1][j] && mask2[index2][j])
-          { double x1 = data1[index1][i];
-            double x2 = data1[index1][j];
-            double y1 = data2[index2][i];
-            double y2 = data2[index2][j];
-            if (x1 < x2 && y1 < y2) con++;
-            if (x1 > x2 && y1 > y2) con++;
-            if (x1 < x2 && y1 > y2) dis++;
-            if (x1 > x2 && y1 < y2) dis++;
-            if (x1 == x2 && y1 != y2) exx++;
-            if (x1 != x2 && y1 == y2) exy++;
-            flag = 1;
-          }
-        }
+      { pairs[m].x = data1[index1][i];
+        pairs[m].y = data2[index2][i];
+        m++;
       }
     }
   }
   else
   { for (i = 0; i < n; i++)
     { if (mask1[i][index1] && mask2[i][index2])
-      { for (j = 0; j < i; j++)
-        { if (mask1[j][index1] && mask2[j][index2])
-          { double x1 = data1[i][index1];
-            double x2 = data1[j][index1];
-            double y1 = data2[i][index2];
-            double y2 = data2[j][index2];
-            if (x1 < x2 && y1 < y2) con++;
-            if (x1 > x2 && y1 > y2) con++;
-            if (x1 < x2 && y1 > y2) dis++;
-            if (x1 > x2 && y1 < y2) dis++;
-            if (x1 == x2 && y1 != y2) exx++;
-            if (x1 != x2 && y1 == y2) exy++;
-            flag = 1;
-          }
-        }
+      { pairs[m].x = data1[i][index1];
+        pairs[m].y = data2[i][index2];
+        m++;
       }
     }
   }
-  if (!flag) return 0.;
+  if (m < 2)
+  { free(pairs);
+    return 0.;
+  }
+  y = malloc(2*m*sizeof(double));
+  if(!y) /* Memory allocation error */
+  { free(pairs);
+    return 0.0;
+  }
+  /* Knight's algorithm: once the pairs are sorted by x, and then by y,
+   * the discordant pairs are the inversions of y, counted while
+   * sorting y by merge sort, in O(m log m) rather than O(m^2).
+   */
+  qsort(pairs, m, sizeof(xypair), comparexy);
+  i = 0;
+  while (i < m)
+  { j = i + 1;
+    while (j < m && pairs[j].x == pairs[i].x) j++;
+    tx += 0.5*(j-i)*(j-i-1);
+    i = j;
+  }
+  i = 0;
+  while (i < m)
+  { j = i + 1;
+    while (j < m && pairs[j].x == pairs[i].x && pairs[j].y == pairs[i].y) j++;
+    txy += 0.5*(j-i)*(j-i-1);
+    i = j;
+  }
+  for (i = 0; i < m; i++) y[i] = pairs[i].y;
+  free(pairs);
+  dis = mergeinversions(m, y, y+m);
+  i = 0;
+  while (i < m)
+  { j = i + 1;
+    while (j < m && y[j] == y[i]) j++;
+    ty += 0.5*(j-i)*(j-i-1);
+    i = j;
+  }
+  free(y);
+  total = 0.5*m*(m-1);
+  exx = tx - txy;
+  exy = ty - txy;
+  con = total - tx - ty + txy - dis;
   denomx = con + dis + exx;
   denomy = con + dis + exy;
   if (denomx==0) return 1;
@@ -2651,6 +2738,81 @@ void kmedoids (int nclusters, int nelements, double** distmatrix,
 
 /* ******************************************************************** */
 
+static void spearmanmatrix (int n, int ndata, double** data, int** mask,
+  const double weights[], int transpose, double** matrix)
+/**
+\internal
+
+Purpose
+=======
+
+The spearmanmatrix routine fills the distance matrix of distancematrix with
+the Spearman distances. The ranks of the rows or columns without missing
+data are calculated once, rather than once for every pair, and their
+Spearman distances are then calculated in the same way as by spearman. The
+distances involving a row or column with missing data are calculated by
+spearman. If not enough memory is available for the ranks, all the distances
+are calculated by spearman.
+
+*/
+{ int i, j, k;
+  const double avgrank = 0.5*(ndata-1); /* Average rank */
+  double** ranks = malloc(n*sizeof(double*));
+  double* denom = malloc(n*sizeof(double));
+  double* values = malloc(ndata*sizeof(double));
+  if (!ranks || !denom || !values) /* Memory allocation error */
+  { free(ranks);
+    ranks = NULL;
+  }
+  else
+  { for (i = 0; i < n; i++)
+    { ranks[i] = NULL;
+      for (k = 0; k < ndata; k++)
+      { if (transpose==0)
+        { if (!mask[i][k]) break;
+          values[k] = data[i][k];
+        }
+        else
+        { if (!mask[k][i]) break;
+          values[k] = data[k][i];
+        }
+      }
+      if (ndata==0 || k < ndata) continue;
+      ranks[i] = getrank(ndata, values);
+      if (!ranks[i]) continue; /* Memory allocation error */
+      denom[i] = 0.;
+      for (k = 0; k < ndata; k++) denom[i] += ranks[i][k] * ranks[i][k];
+      denom[i] /= ndata;
+      denom[i] -= avgrank * avgrank;
+    }
+  }
+  free(values);
+
+  for (i = 1; i < n; i++)
+  { for (j = 0; j < i; j++)
+    { double result = 0.;
+      if (!ranks || !ranks[i] || !ranks[j])
+      { matrix[i][j] =
+          spearman(ndata,data,data,mask,mask,weights,i,j,transpose);
+        continue;
+      }
+      for (k = 0; k < ndata; k++) result += ranks[i][k] * ranks[j][k];
+      result /= ndata;
+      result -= avgrank * avgrank;
+      /* include '<' to deal with roundoff errors */
+      if (denom[i] <= 0 || denom[j] <= 0) matrix[i][j] = 1.;
+      else matrix[i][j] = 1. - result / sqrt(denom[i]*denom[j]);
+    }
+  }
+  if (ranks)
+  { for (i = 0; i < n; i++) free(ranks[i]);
+    free(ranks);
+  }
+  free(denom);
+}
+
+/* ******************************************************************** */
+
 double** distancematrix (int nrows, int ncolumns, double** data,
   int** mask, double weights[], char dist, int transpose)
 { /* First determine the size of the distance matrix */
@@ -2683,9 +2845,12 @@ double** distancematrix (int nrows, int ncolumns, double** data,
   }
 
   /* Calculate the distances and save them in the ragged array */
-  for (i = 1; i < n; i++)
-    for (j = 0; j < i; j++)
-      matrix[i][j]=metric(ndata,data,data,mask,mask,weights,i,j,transpose);
+  if (dist=='s')
+    spearmanmatrix(n, ndata, data, mask, weights, transpose, matrix);
+  else
+    for (i = 1; i < n; i++)
+      for (j = 0; j < i; j++)
+        matrix[i][j]=metric(ndata,data,data,mask,mask,weights,i,j,transpose);
 
   return matrix;
 }
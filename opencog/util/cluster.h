@@ -47,6 +47,10 @@
 
 #define CLUSTERVERSION "1.49"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* Chapter 2 */
 
 /**
@@ -167,6 +171,9 @@ dist=='x': absolute uncentered correlation
 dist=='s': Spearman's rank correlation
 dist=='k': Kendall's tau
 For other values of dist, the default (Euclidean distance) is used.
+Kendall's tau is computed by Knight's algorithm, in O(n log n) time for n
+values. For Spearman's rank correlation, the ranks of each gene or microarray
+without missing values are computed once.
 
 \param transpose  (input) int
 If transpose is equal to zero, the distances between the rows is
@@ -177,6 +184,22 @@ when microarrays are being clustered.
 double** distancematrix (int ngenes, int ndata, double** data,
   int** mask, double* weight, char dist, int transpose);
 
+/**
+The distancematrix_parallel routine calculates the same distance matrix as
+distancematrix, with the same parameters, using all the threads of OpenMP.
+The data are first copied into a contiguous array, and the means and norms
+needed by the correlations are computed once per gene or microarray. The
+distances between genes or microarrays without missing values are then
+computed by SIMD kernels, over tiles of the matrix, so the results can differ
+from those of distancematrix by rounding errors. mask may be NULL if no value
+is missing. For Spearman's rank correlation, the ranks of each gene or
+microarray without missing values are computed once, and correlated as above.
+For Kendall's tau, each gene or microarray without missing values is sorted
+once, so that each distance takes O(n log n) time, as in distancematrix.
+*/
+double** distancematrix_parallel (int ngenes, int ndata, double** data,
+  int** mask, double* weight, char dist, int transpose);
+
 /* Chapter 3 */
 /**
 The getclustercentroids routine calculates the cluster centroids, given to
@@ -345,6 +368,33 @@ void kcluster (int nclusters, int ngenes, int ndata, double** data,
   int** mask, double weight[], int transpose, int npass, char method, char dist,
   int clusterid[], double* error, int* ifound);
 
+/**
+The kcluster_parallel routine performs k-means or k-median clustering of the
+rows of a contiguous matrix, as kcluster with transpose==0, running the passes
+in parallel with OpenMP.
+
+Each pass starts from centers drawn by k-means++ seeding, rather than from a
+random assignment. For the Euclidean and city-block distances on data without
+missing values, Hamerly's bounds are used to skip most distance computations.
+The passes draw their seeds from randGen(), so the result does not depend on
+the number of threads. If npass!=0, the clusters are numbered in the order of
+their first element. The error is the sum of the distances of the elements to
+the centers of their clusters. Spearman's rank correlation and Kendall's tau
+are computed by kcluster.
+
+\param data       (input) double[nrows*ncolumns]
+The data of the elements to be clustered, row after row.
+
+\param mask       (input) unsigned char[nrows*ncolumns]
+If mask[i*ncolumns+j] == 0, then the value at data[i*ncolumns+j] is missing.
+mask may be NULL if no value is missing.
+
+The other parameters are as for kcluster.
+*/
+void kcluster_parallel (int nclusters, int nrows, int ncolumns,
+  const double* data, const unsigned char* mask, double weight[], int npass,
+  char method, char dist, int clusterid[], double* error, int* ifound);
+
 /**
 The kmedoids routine performs k-medoids clustering on a given set of elements,
 using the distance matrix and the number of clusters passed by the user.
@@ -394,6 +444,16 @@ to 0. If kmedoids fails due to a memory allocation error, ifound is set to -1.
 void kmedoids (int nclusters, int nelements, double** distance,
   int npass, int clusterid[], double* error, int* ifound);
 
+/**
+The kmedoids_parallel routine performs k-medoids clustering as kmedoids, with
+the same parameters, running the passes in parallel with OpenMP. Each pass
+starts from medoids drawn by k-means++ seeding, rather than from a random
+assignment. The passes draw their seeds from randGen(), so the result does not
+depend on the number of threads.
+*/
+void kmedoids_parallel (int nclusters, int nelements, double** distance,
+  int npass, int clusterid[], double* error, int* ifound);
+
 /* Chapter 4 */
 /**
  * A Node struct describes a single node in a tree created by hierarchical
@@ -631,6 +691,56 @@ positive integer if the singular value decomposition fails to converge.
 */
 int pca(int m, int n, double** u, double** v, double* w);
 
+/**
+The pca_randomized routine computes only the first ncomponents principal
+components of a real nrows by ncolumns matrix, by a randomized truncated
+singular value decomposition (Halko, Martinsson and Tropp, "Finding structure
+with randomness", 2011): the range of the matrix is sampled by its products
+with a random Gaussian matrix of ncomponents+10 columns, refined by npower
+power iterations, and pca is applied to the data projected on that range. This
+takes O(nrows*ncolumns*ncomponents) operations, rather than
+O(nrows*ncolumns*min(nrows,ncolumns)), and the products with the data are
+blocked and run in parallel with OpenMP. The values are those of pca up to
+rounding errors, and to the accuracy of the sampled range; 1 or 2 power
+iterations are enough, unless the singular values decrease slowly. The random
+matrix is drawn from a seed taken from randGen().
+
+\param nrows       (input) int
+The number of rows of the data.
+
+\param ncolumns    (input) int
+The number of columns of the data.
+
+\param data        (input) double[nrows*ncolumns]
+The data, row after row. As for pca, the mean of each column must already have
+been subtracted. data is not modified.
+
+\param ncomponents (input) int
+The number of principal components to compute, at most min(nrows, ncolumns).
+
+\param npower      (input) int
+The number of power iterations.
+
+\param coordinates (output) double[nrows*ncomponents]
+The coordinates of each row with respect to the principal components.
+
+\param components  (output) double[ncomponents*ncolumns]
+The principal component vectors, one after the other.
+
+\param w           (output) double[ncomponents]
+The first ncomponents values of w computed by pca, largest first.
+
+Return value
+============
+
+The function returns 0 if successful, -1 if ncomponents is out of range or
+memory allocation fails, and a positive integer if the singular value
+decomposition fails to converge.
+*/
+int pca_randomized(int nrows, int ncolumns, const double* data,
+  int ncomponents, int npower, double* coordinates, double* components,
+  double* w);
+
 /**	Sets up an index table given the data, such that data[index[]] is in
  *	increasing order. Sorting is done on the indices; the array data
  *	is unchanged.
@@ -710,6 +820,10 @@ double* calculate_weights(int nrows, int ncolumns, double** data, int** mask,
   double weights[], int transpose, char dist, double cutoff, double exponent);
 
 
+#ifdef __cplusplus
+}
+#endif
+
 ///@}
 /** @}*/
 
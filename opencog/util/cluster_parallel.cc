@@ -0,0 +1,1223 @@
+/*
+ * opencog/util/cluster_parallel.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Multi-threaded versions of routines of the C clustering library
+// (cluster.c), which is compiled without OpenMP.
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "cluster.h"
+#include "fast_rng.h"
+#include "kmeans_seeding.h"
+#include "mt19937ar.h"
+#include "random.h"
+#include "simd_distance.h"
+
+namespace opencog
+{
+
+namespace {
+
+/**
+ * Catches a std::bad_alloc in the body of an OpenMP loop, which an
+ * exception may not leave, to rethrow it once the loop is over.
+ */
+class alloc_guard
+{
+public:
+    template<typename Body>
+    void operator()(Body&& body) noexcept
+    {
+        try {
+            body();
+        } catch (const std::bad_alloc&) {
+            _failed = true;
+        }
+    }
+
+    void rethrow() const
+    {
+        if (_failed) throw std::bad_alloc();
+    }
+
+private:
+    std::atomic<bool> _failed{false};
+};
+
+/**
+ * The elements to compare (rows, or columns if transpose), copied one
+ * after the other, with their masks. mask may be NULL if no value is
+ * missing.
+ */
+struct packed_elements
+{
+    int n, m;
+    std::vector<double> x;
+    //empty if no value is missing
+    std::vector<unsigned char> valid;
+    //whether no value of element i is missing
+    std::vector<char> complete;
+
+    packed_elements(int nrows, int ncolumns, double** data, int** mask,
+                    int transpose)
+        : n(transpose ? ncolumns : nrows), m(transpose ? nrows : ncolumns),
+          x(size_t(n) * m), complete(n, 1)
+    {
+        bool any_missing = false;
+        for (int i = 0; i < n; i++)
+            for (int k = 0; k < m; k++) {
+                x[size_t(i) * m + k] = transpose ? data[k][i] : data[i][k];
+                if (mask and not (transpose ? mask[k][i] : mask[i][k])) {
+                    complete[i] = 0;
+                    any_missing = true;
+                }
+            }
+        if (not any_missing) return;
+        valid.resize(x.size());
+        for (int i = 0; i < n; i++)
+            for (int k = 0; k < m; k++)
+                valid[size_t(i) * m + k] =
+                    (transpose ? mask[k][i] : mask[i][k]) != 0;
+    }
+
+    const double* row(int i) const { return &x[size_t(i) * m]; }
+    const unsigned char* valid_row(int i) const
+    {
+        return &valid[size_t(i) * m];
+    }
+};
+
+/**
+ * Distance between elements a and b, computed as in cluster.c. If
+ * Masked, only the values valid in both va and vb are compared.
+ */
+template<bool Masked>
+double pair_distance(char dist, int m, const double* a, const double* b,
+                     const unsigned char* va, const unsigned char* vb,
+                     const double* w)
+{
+    double sum1 = 0, sum2 = 0, ab = 0, aa = 0, bb = 0, l1 = 0, l2 = 0;
+    double tweight = 0;
+    bool flag = false;
+    for (int k = 0; k < m; k++) {
+        if (Masked and not (va[k] and vb[k])) continue;
+        double d = a[k] - b[k];
+        sum1 += w[k] * a[k];
+        sum2 += w[k] * b[k];
+        ab += w[k] * a[k] * b[k];
+        aa += w[k] * a[k] * a[k];
+        bb += w[k] * b[k] * b[k];
+        l1 += w[k] * std::fabs(d);
+        l2 += w[k] * d * d;
+        tweight += w[k];
+        flag = true;
+    }
+    switch (dist) {
+    case 'b':
+        return tweight ? l1 / tweight : 0;
+    case 'c':
+    case 'a':
+        if (not tweight) return 0;
+        ab -= sum1 * sum2 / tweight;
+        aa -= sum1 * sum1 / tweight;
+        bb -= sum2 * sum2 / tweight;
+        if (aa <= 0 or bb <= 0) return 1;
+        ab /= std::sqrt(aa * bb);
+        return 1 - (dist == 'a' ? std::fabs(ab) : ab);
+    case 'u':
+    case 'x':
+        if (not flag) return 0;
+        if (aa == 0 or bb == 0) return 1;
+        ab /= std::sqrt(aa * bb);
+        return 1 - (dist == 'x' ? std::fabs(ab) : ab);
+    default:
+        return tweight ? l2 / tweight : 0;
+    }
+}
+
+/**
+ * Ranks of the m values of x, as computed by getrank in cluster.c:
+ * from 0, equal values getting the average of their ranks. order is a
+ * workspace of m ints.
+ */
+void average_ranks(int m, const double* x, double* rank, int* order)
+{
+    std::iota(order, order + m, 0);
+    std::sort(order, order + m, [x](int a, int b) { return x[a] < x[b]; });
+    for (int i = 0; i < m;) {
+        int j = i + 1;
+        while (j < m and x[order[j]] == x[order[i]]) j++;
+        for (int k = i; k < j; k++) rank[order[k]] = i + (j - i - 1) / 2.;
+        i = j;
+    }
+}
+
+//! Number of pairs of equal elements in [first, last), where equal
+//! elements are next to each other.
+template<typename It, typename Equal>
+double tied_pairs(It first, It last, Equal equal)
+{
+    double ties = 0;
+    while (first != last) {
+        It run = first;
+        double count = 0;
+        for (; first != last and equal(*run, *first); ++first) count++;
+        ties += 0.5 * count * (count - 1);
+    }
+    return ties;
+}
+
+//! Workspace of the rank correlations, for one thread.
+struct rank_scratch
+{
+    std::vector<double> x, y, rx, ry, buffer;
+    std::vector<int> order;
+    std::vector<std::pair<double, double>> pairs;
+
+    explicit rank_scratch(int m)
+        : x(m), y(m), rx(m), ry(m), buffer(m), order(m), pairs(m) {}
+};
+
+/**
+ * Spearman distance between elements a and b, over the values valid
+ * in both va and vb, computed as by spearman in cluster.c.
+ */
+double spearman_distance(int m, const double* a, const double* b,
+                         const unsigned char* va, const unsigned char* vb,
+                         rank_scratch& s)
+{
+    int n = 0;
+    for (int k = 0; k < m; k++) {
+        if (not (va[k] and vb[k])) continue;
+        s.x[n] = a[k];
+        s.y[n] = b[k];
+        n++;
+    }
+    if (n == 0) return 0;
+    average_ranks(n, s.x.data(), s.rx.data(), s.order.data());
+    average_ranks(n, s.y.data(), s.ry.data(), s.order.data());
+    double result = 0, denom1 = 0, denom2 = 0;
+    for (int k = 0; k < n; k++) {
+        result += s.rx[k] * s.ry[k];
+        denom1 += s.rx[k] * s.rx[k];
+        denom2 += s.ry[k] * s.ry[k];
+    }
+    double avgrank = 0.5 * (n - 1);
+    result = result / n - avgrank * avgrank;
+    denom1 = denom1 / n - avgrank * avgrank;
+    denom2 = denom2 / n - avgrank * avgrank;
+    if (denom1 <= 0 or denom2 <= 0) return 1;
+    return 1 - result / std::sqrt(denom1 * denom2);
+}
+
+/**
+ * Kendall distance, by Knight's algorithm as in cluster.c, given the
+ * y values of m pairs sorted by x and then by y, the number tx of
+ * pairs tied in x, and the number txy of pairs tied in both. The
+ * discordant pairs are the inversions of y, counted while sorting it
+ * by merge sort, using buffer, of m values.
+ */
+double kendall_sorted(int m, double* y, double tx, double txy,
+                      double* buffer)
+{
+    if (m < 2) return 0;
+    double dis = 0;
+    for (int width = 1; width < m; width *= 2)
+        for (int lo = 0; lo < m - width; lo += 2 * width) {
+            int mid = lo + width, hi = std::min(m - mid, width) + mid;
+            int a = lo, b = mid, k = lo;
+            while (a < mid and b < hi) {
+                if (y[b] < y[a]) {
+                    dis += mid - a;
+                    buffer[k++] = y[b++];
+                } else
+                    buffer[k++] = y[a++];
+            }
+            // What is left of the second half is already in place.
+            std::copy(y + a, y + mid, buffer + k);
+            std::copy(buffer + lo, buffer + b, y + lo);
+        }
+    double ty = tied_pairs(y, y + m, std::equal_to<double>());
+    double total = 0.5 * m * (m - 1);
+    double denomx = total - ty, denomy = total - tx;
+    if (denomx == 0 or denomy == 0) return 1;
+    double con = total - tx - ty + txy - dis;
+    return 1 - (con - dis) / std::sqrt(denomx * denomy);
+}
+
+/**
+ * Kendall distance between elements a and b, over the values valid
+ * in both va and vb, computed as by kendall in cluster.c.
+ */
+double kendall_distance(int m, const double* a, const double* b,
+                        const unsigned char* va, const unsigned char* vb,
+                        rank_scratch& s)
+{
+    int n = 0;
+    for (int k = 0; k < m; k++)
+        if (va[k] and vb[k]) s.pairs[n++] = {a[k], b[k]};
+    auto first = s.pairs.begin(), last = first + n;
+    std::sort(first, last);
+    double tx = tied_pairs(first, last,
+        [](const std::pair<double, double>& p,
+           const std::pair<double, double>& q) {
+            return p.first == q.first;
+        });
+    double txy = tied_pairs(first, last,
+                            std::equal_to<std::pair<double, double>>());
+    for (int k = 0; k < n; k++) s.y[k] = s.pairs[k].second;
+    return kendall_sorted(n, s.y.data(), tx, txy, s.buffer.data());
+}
+
+/**
+ * Kendall distances between complete elements. Each element is
+ * sorted once, so that comparing two elements only sorts the values
+ * of the second within the ties of the first, before counting the
+ * inversions.
+ */
+struct kendall_metric
+{
+    const packed_elements& pe;
+    //the order of the values of each element, and its ties
+    std::vector<int> order;
+    std::vector<double> ties;
+
+    explicit kendall_metric(const packed_elements& pe)
+        : pe(pe), order(pe.x.size()), ties(pe.n, 0)
+    {
+        for (int i = 0; i < pe.n; i++) {
+            if (not pe.complete[i]) continue;
+            const double* x = pe.row(i);
+            int* o = &order[size_t(i) * pe.m];
+            std::iota(o, o + pe.m, 0);
+            std::sort(o, o + pe.m,
+                      [x](int a, int b) { return x[a] < x[b]; });
+            ties[i] = tied_pairs(o, o + pe.m,
+                [x](int a, int b) { return x[a] == x[b]; });
+        }
+    }
+
+    double operator()(int i, int j, rank_scratch& s) const
+    {
+        const int m = pe.m;
+        const double* x = pe.row(i);
+        const double* y = pe.row(j);
+        const int* o = &order[size_t(i) * m];
+        double* sy = s.y.data();
+        for (int k = 0; k < m; k++) sy[k] = y[o[k]];
+        double txy = 0;
+        for (int k = 0; k < m;) {
+            int l = k + 1;
+            while (l < m and x[o[l]] == x[o[k]]) l++;
+            if (l - k > 1) {
+                std::sort(sy + k, sy + l);
+                txy += tied_pairs(sy + k, sy + l, std::equal_to<double>());
+            }
+            k = l;
+        }
+        return kendall_sorted(m, sy, ties[i], txy, s.buffer.data());
+    }
+};
+
+/**
+ * Distances between complete elements, reduced to a squared euclidean
+ * or a city block distance between transformed elements:
+ *
+ * - 'e': x_k sqrt(w_k), and the squared distance over sum(w);
+ * - 'b': x_k w_k, and the city block distance over sum(w);
+ * - 'c', 'a': x centered on its weighted mean, times sqrt(w), and
+ *   normalized, so that the correlation is 1 - |y1 - y2|^2 / 2;
+ * - 'u', 'x': the same, without centering;
+ * - 's': the ranks of x, as for 'c' with equal weights, since
+ *   Spearman's rank correlation is the correlation of the ranks.
+ *
+ * The means and norms, and the ranks, are thus computed once per
+ * element, rather than for every pair.
+ */
+struct complete_metric
+{
+    char dist;
+    int m;
+    std::vector<double> y;
+    //whether the correlation of element i is undefined (it is constant)
+    std::vector<char> constant;
+    double tweight;
+
+    complete_metric(char dist, const packed_elements& pe, const double* w)
+        : dist(dist), m(pe.m), y(pe.x.size()), constant(pe.n, 0), tweight(0)
+    {
+        // As spearman in cluster.c, ignore the weights.
+        std::vector<double> unit, ranks;
+        std::vector<int> order;
+        if (dist == 's') {
+            unit.assign(m, 1);
+            ranks.resize(m);
+            order.resize(m);
+            w = unit.data();
+        }
+        for (int k = 0; k < m; k++) tweight += w[k];
+        for (int i = 0; i < pe.n; i++) {
+            if (not pe.complete[i]) continue;
+            const double* x = pe.row(i);
+            if (dist == 's') {
+                average_ranks(m, x, ranks.data(), order.data());
+                x = ranks.data();
+            }
+            double* yi = &y[size_t(i) * m];
+            if (dist == 'b') {
+                for (int k = 0; k < m; k++) yi[k] = x[k] * w[k];
+                continue;
+            }
+            double mean = 0;
+            if ((dist == 'c' or dist == 'a' or dist == 's') and tweight) {
+                for (int k = 0; k < m; k++) mean += w[k] * x[k];
+                mean /= tweight;
+            }
+            double sumsq = 0, norm = 0;
+            for (int k = 0; k < m; k++) {
+                yi[k] = (x[k] - mean) * std::sqrt(w[k]);
+                sumsq += w[k] * x[k] * x[k];
+                norm += yi[k] * yi[k];
+            }
+            if (dist == 'e') continue;
+            // Centering leaves rounding errors of a constant element,
+            // which must not be taken for variance.
+            constant[i] = dist == 'u' or dist == 'x' ?
+                norm == 0 : norm <= 1e-24 * sumsq;
+            if (constant[i]) continue;
+            norm = std::sqrt(norm);
+            for (int k = 0; k < m; k++) yi[k] /= norm;
+        }
+    }
+
+    double operator()(int i, int j) const
+    {
+        const double* a = &y[size_t(i) * m];
+        const double* b = &y[size_t(j) * m];
+        switch (dist) {
+        case 'e':
+            return tweight ? l2_distance_sq(a, b, m) / tweight : 0;
+        case 'b':
+            return tweight ? l1_distance(a, b, m) / tweight : 0;
+        case 'c':
+        case 'a':
+        case 's':
+            if (not tweight) return 0;
+            // fall through
+        default:
+            if (constant[i] or constant[j]) return 1;
+            double r = 1 - l2_distance_sq(a, b, m) / 2;
+            return 1 - ((dist == 'a' or dist == 'x') ? std::fabs(r) : r);
+        }
+    }
+};
+
+//! Free the first n rows of a matrix of alloc_lower_triangle.
+void free_lower_triangle(double** matrix, int n)
+{
+    for (int i = 1; i < n; i++) free(matrix[i]);
+    free(matrix);
+}
+
+//! Allocate the ragged lower triangular matrix of distancematrix.
+double** alloc_lower_triangle(int n)
+{
+    double** matrix = (double**)malloc(n * sizeof(double*));
+    if (matrix == NULL) return NULL;
+    matrix[0] = NULL;
+    for (int i = 1; i < n; i++) {
+        matrix[i] = (double*)malloc(i * sizeof(double));
+        if (matrix[i] == NULL) {
+            free_lower_triangle(matrix, i);
+            return NULL;
+        }
+    }
+    return matrix;
+}
+
+/**
+ * Set matrix[i][j] to distance(i, j, scratch) for all j < i < n, by
+ * tiles of the lower triangle, so that the elements of a tile stay in
+ * cache while compared with each other. scratch is a rank_scratch for
+ * elements of m values.
+ */
+template<typename Distance>
+void fill_lower_triangle(double** matrix, int n, int m,
+                         const Distance& distance)
+{
+    const int tile = 64;
+    std::vector<std::pair<int, int>> tiles;
+    for (int ti = 0; ti < n; ti += tile)
+        for (int tj = 0; tj <= ti; tj += tile)
+            tiles.push_back({ti, tj});
+
+    alloc_guard guard;
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t t = 0; t < tiles.size(); t++) guard([&] {
+        rank_scratch scratch(m);
+        int ti = tiles[t].first, tj = tiles[t].second;
+        for (int i = ti; i < std::min(ti + tile, n); i++) {
+            int jend = std::min(tj + tile, i);
+            for (int j = tj; j < jend; j++)
+                matrix[i][j] = distance(i, j, scratch);
+        }
+    });
+    guard.rethrow();
+}
+
+} // ~namespace
+
+} // ~namespace opencog
+
+using namespace opencog;
+
+double** distancematrix_parallel(int nrows, int ncolumns, double** data,
+                                 int** mask, double* weights, char dist,
+                                 int transpose)
+{
+    switch (dist) {
+    case 'e': case 'b': case 'c': case 'a': case 'u': case 'x':
+    case 's': case 'k':
+        break;
+    default:
+        dist = 'e';
+    }
+    const int n = transpose ? ncolumns : nrows;
+    if (n < 2) return NULL;
+    double** matrix = alloc_lower_triangle(n);
+    if (matrix == NULL) return NULL;
+
+    try {
+        packed_elements pe(nrows, ncolumns, data, mask, transpose);
+        if (dist == 'k') {
+            kendall_metric metric(pe);
+            fill_lower_triangle(matrix, n, pe.m,
+                [&](int i, int j, rank_scratch& s) {
+                    if (pe.complete[i] and pe.complete[j])
+                        return metric(i, j, s);
+                    return kendall_distance(pe.m, pe.row(i), pe.row(j),
+                                            pe.valid_row(i), pe.valid_row(j),
+                                            s);
+                });
+            return matrix;
+        }
+
+        complete_metric metric(dist, pe, weights);
+        fill_lower_triangle(matrix, n, pe.m,
+            [&](int i, int j, rank_scratch& s) {
+                if (pe.complete[i] and pe.complete[j]) return metric(i, j);
+                if (dist == 's')
+                    return spearman_distance(pe.m, pe.row(i), pe.row(j),
+                                             pe.valid_row(i),
+                                             pe.valid_row(j), s);
+                return pair_distance<true>(dist, pe.m, pe.row(i), pe.row(j),
+                                           pe.valid_row(i), pe.valid_row(j),
+                                           weights);
+            });
+        return matrix;
+    } catch (const std::bad_alloc&) {
+        free_lower_triangle(matrix, n);
+        return NULL;
+    }
+}
+
+namespace opencog
+{
+
+namespace {
+
+/**
+ * Rows of a contiguous matrix to cluster, and the distance between a
+ * row and a center.
+ *
+ * For the euclidean and city block distances on complete data, the
+ * rows are scaled by the weights, as in distancematrix_parallel, and
+ * rows are assigned by the square root of l2_distance_sq, or by
+ * l1_distance, which satisfy the triangle inequality, so that
+ * Hamerly's bounds can skip most of the distance computations. The
+ * means, and medians, of the scaled rows are the scaled centers.
+ */
+struct kmeans_data
+{
+    int n, m;
+    const double* x;
+    //NULL if no value is missing
+    const unsigned char* mask;
+    const double* w;
+    char dist;
+    char method;
+    double tweight;
+    bool pruned;
+    std::vector<double> scaled;
+
+    kmeans_data(int n, int m, const double* data, const unsigned char* mask,
+                const double* w, char dist, char method)
+        : n(n), m(m), x(data), mask(mask), w(w), dist(dist), method(method),
+          tweight(0)
+    {
+        for (int k = 0; k < m; k++) tweight += w[k];
+        if (mask and std::all_of(mask, mask + size_t(n) * m,
+                                 [](unsigned char v) { return v != 0; }))
+            this->mask = NULL;
+        pruned = this->mask == NULL and (dist == 'e' or dist == 'b');
+        if (not pruned) return;
+        scaled.resize(size_t(n) * m);
+        for (int i = 0; i < n; i++)
+            for (int k = 0; k < m; k++)
+                scaled[size_t(i) * m + k] = data[size_t(i) * m + k] *
+                    (dist == 'e' ? std::sqrt(w[k]) : w[k]);
+        x = scaled.data();
+    }
+
+    const double* row(int i) const { return x + size_t(i) * m; }
+    const unsigned char* valid(int i) const
+    {
+        return mask ? mask + size_t(i) * m : NULL;
+    }
+
+    //! Distance used to assign row a to center c.
+    double distance(const double* a, const unsigned char* va,
+                    const double* c, const unsigned char* vc) const
+    {
+        if (pruned)
+            return dist == 'e' ? std::sqrt(l2_distance_sq(a, c, m))
+                : l1_distance(a, c, m);
+        if (mask) return pair_distance<true>(dist, m, a, c, va, vc, w);
+        return pair_distance<false>(dist, m, a, c, NULL, NULL, w);
+    }
+
+    //! Distance of cluster.c, given the one above.
+    double error(double d) const
+    {
+        if (not pruned) return d;
+        if (not tweight) return 0;
+        return (dist == 'e' ? d * d : d) / tweight;
+    }
+
+    //! Weight of a row in k-means++ seeding, given the distance to
+    //! its nearest center: the squared distance.
+    double seed_weight(double d) const
+    {
+        return dist == 'e' and not pruned ? d : d * d;
+    }
+};
+
+/**
+ * One pass of k-means, or k-medians, over kmeans_data. The pass
+ * starts with a k-means++ seeding, or from given clusters, and then
+ * alternates computing the centers and assigning each row to its
+ * nearest center, until the clusters do not change or cycle. As in
+ * kcluster, a row never leaves a cluster of its own.
+ */
+class kmeans_pass
+{
+    const kmeans_data& d;
+    const int k;
+    std::vector<double> c, old_c;
+    std::vector<unsigned char> c_valid;
+    std::vector<int> counts;
+    //Hamerly's bounds: upper bound on the distance of each row to its
+    //center, lower bound on the distances to the other centers, and
+    //half the distance of each center to the nearest other.
+    std::vector<double> upper, lower, half_gap;
+
+public:
+    std::vector<int> clusterid;
+    double error;
+
+    kmeans_pass(const kmeans_data& d, int k)
+        : d(d), k(k), c(size_t(k) * d.m), old_c(c.size()),
+          c_valid(d.mask ? c.size() : 0), counts(k), upper(d.n, DBL_MAX),
+          lower(d.n, 0), half_gap(k, 0), clusterid(d.n), error(0) {}
+
+    void seed(RandGen& rng)
+    {
+        std::vector<int> seeds;
+        kmeans_pp_seeding(d.n, k, rng,
+            [&](int j, int s) {
+                seeds.push_back(s);
+                std::copy(d.row(s), d.row(s) + d.m, center(j));
+                if (d.mask)
+                    std::copy(d.valid(s), d.valid(s) + d.m,
+                              &c_valid[size_t(j) * d.m]);
+            },
+            [&](int i, int j) { return d.seed_weight(distance(i, j)); });
+
+        for (int i = 0; i < d.n; i++) {
+            double best = DBL_MAX;
+            for (int j = 0; j < k; j++) {
+                double dj = distance(i, j);
+                if (dj < best) {
+                    best = dj;
+                    clusterid[i] = j;
+                }
+            }
+        }
+        // Duplicate seeds would leave clusters empty.
+        for (int j = 0; j < k; j++) clusterid[seeds[j]] = j;
+        count();
+    }
+
+    void start_from(const int* initial)
+    {
+        std::copy(initial, initial + d.n, clusterid.begin());
+        count();
+    }
+
+    void run()
+    {
+        std::vector<int> saved;
+        int counter = 0, period = 10;
+        bool changed = true;
+        while (changed) {
+            if (counter % period == 0) {
+                saved = clusterid;
+                if (period < INT_MAX / 2) period *= 2;
+            }
+            counter++;
+
+            update_centers();
+            changed = assign();
+            if (changed and clusterid == saved) {
+                update_centers();
+                break;
+            }
+        }
+        error = 0;
+        for (int i = 0; i < d.n; i++)
+            error += d.error(distance(i, clusterid[i]));
+    }
+
+private:
+    double* center(int j) { return &c[size_t(j) * d.m]; }
+    const double* center(int j) const { return &c[size_t(j) * d.m]; }
+    const unsigned char* center_valid(int j) const
+    {
+        return d.mask ? &c_valid[size_t(j) * d.m] : NULL;
+    }
+
+    double distance(int i, int j) const
+    {
+        return d.distance(d.row(i), d.valid(i), center(j), center_valid(j));
+    }
+
+    void count()
+    {
+        std::fill(counts.begin(), counts.end(), 0);
+        for (int id : clusterid) counts[id]++;
+    }
+
+    void update_centers()
+    {
+        std::swap(c, old_c);
+        if (d.method == 'm') medians();
+        else means();
+        if (d.pruned) update_bounds();
+    }
+
+    void means()
+    {
+        std::fill(c.begin(), c.end(), 0.0);
+        std::vector<int> n(d.mask ? c.size() : 0);
+        for (int i = 0; i < d.n; i++) {
+            const double* x = d.row(i);
+            const unsigned char* v = d.valid(i);
+            size_t offset = size_t(clusterid[i]) * d.m;
+            for (int l = 0; l < d.m; l++) {
+                if (d.mask and not v[l]) continue;
+                c[offset + l] += x[l];
+                if (d.mask) n[offset + l]++;
+            }
+        }
+        for (int j = 0; j < k; j++)
+            for (int l = 0; l < d.m; l++) {
+                size_t jl = size_t(j) * d.m + l;
+                if (not d.mask) {
+                    if (counts[j]) c[jl] /= counts[j];
+                } else {
+                    c_valid[jl] = n[jl] > 0;
+                    if (n[jl]) c[jl] /= n[jl];
+                }
+            }
+    }
+
+    void medians()
+    {
+        // Rows sorted by cluster
+        std::vector<int> first(k + 1, 0), members(d.n);
+        for (int j = 0; j < k; j++) first[j + 1] = first[j] + counts[j];
+        std::vector<int> next(first.begin(), first.end() - 1);
+        for (int i = 0; i < d.n; i++) members[next[clusterid[i]]++] = i;
+
+        std::vector<double> values;
+        for (int j = 0; j < k; j++)
+            for (int l = 0; l < d.m; l++) {
+                values.clear();
+                for (int e = first[j]; e < first[j + 1]; e++) {
+                    int i = members[e];
+                    if (not d.mask or d.valid(i)[l])
+                        values.push_back(d.row(i)[l]);
+                }
+                c[size_t(j) * d.m + l] =
+                    median(int(values.size()), values.data());
+                if (d.mask) c_valid[size_t(j) * d.m + l] = not values.empty();
+            }
+    }
+
+    //! Loosen the bounds by how much the centers moved.
+    void update_bounds()
+    {
+        std::vector<double> moved(k);
+        int farthest = 0;
+        double second = 0;
+        for (int j = 0; j < k; j++) {
+            moved[j] = d.distance(&old_c[size_t(j) * d.m], NULL, center(j),
+                                  NULL);
+            if (moved[j] > moved[farthest]) {
+                second = moved[farthest];
+                farthest = j;
+            } else if (j != farthest and moved[j] > second)
+                second = moved[j];
+        }
+        for (int i = 0; i < d.n; i++) {
+            int a = clusterid[i];
+            upper[i] += moved[a];
+            lower[i] -= a == farthest ? second : moved[farthest];
+        }
+        for (int j = 0; j < k; j++) {
+            half_gap[j] = DBL_MAX;
+            for (int l = 0; l < k; l++)
+                if (l != j)
+                    half_gap[j] = std::min(half_gap[j],
+                        d.distance(center(j), NULL, center(l), NULL) / 2);
+        }
+    }
+
+    //! Move each row to its nearest center; return whether any moved.
+    bool assign()
+    {
+        bool changed = false;
+        for (int i = 0; i < d.n; i++) {
+            int a = clusterid[i];
+            if (counts[a] == 1) continue;
+            double bound = 0;
+            if (d.pruned) {
+                bound = std::max(half_gap[a], lower[i]);
+                if (upper[i] <= bound) continue;
+                upper[i] = distance(i, a);
+                if (upper[i] <= bound) continue;
+            }
+            double best = d.pruned ? upper[i] : distance(i, a);
+            double second = DBL_MAX;
+            int b = a;
+            for (int j = 0; j < k; j++) {
+                if (j == a) continue;
+                double dj = distance(i, j);
+                if (dj < best) {
+                    second = best;
+                    best = dj;
+                    b = j;
+                } else if (dj < second)
+                    second = dj;
+            }
+            upper[i] = best;
+            lower[i] = second;
+            if (b != a) {
+                counts[a]--;
+                counts[b]++;
+                clusterid[i] = b;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+};
+
+//! Number the clusters in the order of their first element.
+void relabel(std::vector<int>& clusterid, int k)
+{
+    std::vector<int> label(k, -1);
+    int next = 0;
+    for (int& id : clusterid) {
+        if (label[id] < 0) label[id] = next++;
+        id = label[id];
+    }
+}
+
+/**
+ * Pick the solution of least error among the passes, and count how
+ * many passes found it.
+ */
+void best_solution(const std::vector<std::vector<int>>& solutions,
+                   const std::vector<double>& errors, int clusterid[],
+                   double* error, int* ifound)
+{
+    size_t best = 0;
+    for (size_t p = 1; p < errors.size(); p++)
+        if (errors[p] < errors[best]) best = p;
+    std::copy(solutions[best].begin(), solutions[best].end(), clusterid);
+    *error = errors[best];
+    *ifound = std::count(solutions.begin(), solutions.end(),
+                         solutions[best]);
+}
+
+/**
+ * Seeds of the passes, drawn from randGen() so that they do not
+ * depend on the scheduling of the threads.
+ */
+std::vector<unsigned> pass_seeds(int npass)
+{
+    std::vector<unsigned> seeds(npass);
+    for (unsigned& s : seeds) s = randGen().randint();
+    return seeds;
+}
+
+} // ~namespace
+
+} // ~namespace opencog
+
+void kcluster_parallel(int nclusters, int nrows, int ncolumns,
+                       const double* data, const unsigned char* mask,
+                       double weight[], int npass, char method, char dist,
+                       int clusterid[], double* error, int* ifound)
+{
+    if (nrows < nclusters) {
+        *ifound = 0;
+        return;
+    }
+    try {
+        switch (dist) {
+        case 'e': case 'b': case 'c': case 'a': case 'u': case 'x':
+            break;
+        case 's': case 'k': {
+            std::vector<double*> rows(nrows);
+            std::vector<int> valid(size_t(nrows) * ncolumns, 1);
+            std::vector<int*> masks(nrows);
+            for (int i = 0; i < nrows; i++) {
+                rows[i] = const_cast<double*>(data) + size_t(i) * ncolumns;
+                masks[i] = &valid[size_t(i) * ncolumns];
+            }
+            if (mask)
+                std::copy(mask, mask + valid.size(), valid.begin());
+            kcluster(nclusters, nrows, ncolumns, rows.data(), masks.data(),
+                     weight, 0, npass, method, dist, clusterid, error, ifound);
+            return;
+        }
+        default:
+            dist = 'e';
+        }
+
+        kmeans_data kd(nrows, ncolumns, data, mask, weight, dist, method);
+        const int passes = std::max(npass, 1);
+        std::vector<unsigned> seeds = pass_seeds(passes);
+        std::vector<std::vector<int>> solutions(passes);
+        std::vector<double> errors(passes);
+
+        alloc_guard guard;
+        #pragma omp parallel for schedule(dynamic)
+        for (int p = 0; p < passes; p++) guard([&] {
+            kmeans_pass pass(kd, nclusters);
+            if (npass == 0)
+                pass.start_from(clusterid);
+            else {
+                MT19937RandGen rng(seeds[p]);
+                pass.seed(rng);
+            }
+            pass.run();
+            if (npass != 0) relabel(pass.clusterid, nclusters);
+            solutions[p] = std::move(pass.clusterid);
+            errors[p] = pass.error;
+        });
+        guard.rethrow();
+        best_solution(solutions, errors, clusterid, error, ifound);
+    } catch (const std::bad_alloc&) {
+        *ifound = -1;
+    }
+}
+
+void kmedoids_parallel(int nclusters, int nelements, double** distmatrix,
+                       int npass, int clusterid[], double* error,
+                       int* ifound)
+{
+    if (nelements < nclusters) {
+        *ifound = 0;
+        return;
+    }
+    try {
+        auto dist = [distmatrix](int i, int j) {
+            return i == j ? 0 : i > j ? distmatrix[i][j] : distmatrix[j][i];
+        };
+        const int passes = std::max(npass, 1);
+        std::vector<unsigned> seeds = pass_seeds(passes);
+        std::vector<std::vector<int>> solutions(passes);
+        std::vector<double> errors(passes);
+
+        alloc_guard guard;
+        #pragma omp parallel for schedule(dynamic)
+        for (int p = 0; p < passes; p++) guard([&] {
+            std::vector<int> tclusterid(nelements), medoids(nclusters);
+            if (npass == 0) {
+                std::copy(clusterid, clusterid + nelements, tclusterid.begin());
+            } else {
+                // k-means++ seeding of the medoids
+                MT19937RandGen rng(seeds[p]);
+                kmeans_pp_seeding(nelements, nclusters, rng,
+                    [&](int j, int s) { medoids[j] = s; },
+                    [&](int i, int j) {
+                        double d = dist(i, medoids[j]);
+                        return d * d;
+                    });
+                for (int i = 0; i < nelements; i++) {
+                    double best = DBL_MAX;
+                    for (int j = 0; j < nclusters; j++)
+                        if (dist(i, medoids[j]) < best) {
+                            best = dist(i, medoids[j]);
+                            tclusterid[i] = j;
+                        }
+                }
+                for (int j = 0; j < nclusters; j++) tclusterid[medoids[j]] = j;
+            }
+
+            // As in kmedoids, with the members of each cluster listed, so
+            // that finding the medoids takes the sum of the squared sizes
+            // of the clusters rather than nelements^2.
+            std::vector<int> saved, first(nclusters + 1), members(nelements);
+            int counter = 0, period = 10;
+            double total = DBL_MAX;
+            while (true) {
+                double previous = total;
+                if (counter % period == 0) {
+                    saved = tclusterid;
+                    if (period < INT_MAX / 2) period *= 2;
+                }
+                counter++;
+
+                std::fill(first.begin(), first.end(), 0);
+                for (int id : tclusterid) first[id + 1]++;
+                for (int j = 0; j < nclusters; j++) first[j + 1] += first[j];
+                std::vector<int> next(first.begin(), first.end() - 1);
+                for (int i = 0; i < nelements; i++)
+                    members[next[tclusterid[i]]++] = i;
+                for (int j = 0; j < nclusters; j++) {
+                    double least = DBL_MAX;
+                    for (int e = first[j]; e < first[j + 1]; e++) {
+                        double d = 0;
+                        for (int f = first[j]; f < first[j + 1] and d <= least;
+                             f++)
+                            d += dist(members[e], members[f]);
+                        if (d < least) {
+                            least = d;
+                            medoids[j] = members[e];
+                        }
+                    }
+                }
+
+                total = 0;
+                for (int i = 0; i < nelements; i++) {
+                    double distance = DBL_MAX;
+                    for (int j = 0; j < nclusters; j++) {
+                        if (i == medoids[j]) {
+                            distance = 0;
+                            tclusterid[i] = j;
+                            break;
+                        }
+                        double d = dist(i, medoids[j]);
+                        if (d < distance) {
+                            distance = d;
+                            tclusterid[i] = j;
+                        }
+                    }
+                    total += distance;
+                }
+                if (total >= previous or tclusterid == saved) break;
+            }
+            for (int& id : tclusterid) id = medoids[id];
+            solutions[p] = std::move(tclusterid);
+            errors[p] = total;
+        });
+        guard.rethrow();
+        best_solution(solutions, errors, clusterid, error, ifound);
+    } catch (const std::bad_alloc&) {
+        *ifound = -1;
+    }
+}
+
+namespace opencog
+{
+
+namespace {
+
+// Rows and columns of the matrix handled together by the products, so
+// that the rows of the other operand they use stay in cache.
+const int row_block = 64;
+const int column_block = 256;
+
+//! Y = A X, for A m x n and X n x l, all row after row.
+void multiply(const double* A, int m, int n, const double* X, int l,
+              double* Y)
+{
+    #pragma omp parallel for schedule(static)
+    for (int ib = 0; ib < m; ib += row_block) {
+        int iend = std::min(ib + row_block, m);
+        std::fill(Y + size_t(ib) * l, Y + size_t(iend) * l, 0.0);
+        for (int kb = 0; kb < n; kb += column_block) {
+            int kend = std::min(kb + column_block, n);
+            for (int i = ib; i < iend; i++) {
+                const double* a = A + size_t(i) * n;
+                double* y = Y + size_t(i) * l;
+                for (int k = kb; k < kend; k++) {
+                    const double* x = X + size_t(k) * l;
+                    for (int r = 0; r < l; r++) y[r] += a[k] * x[r];
+                }
+            }
+        }
+    }
+}
+
+//! Z = A^T Y, for A m x n and Y m x l, all row after row.
+void multiply_transposed(const double* A, int m, int n, const double* Y,
+                         int l, double* Z)
+{
+    #pragma omp parallel for schedule(static)
+    for (int kb = 0; kb < n; kb += row_block) {
+        int kend = std::min(kb + row_block, n);
+        std::fill(Z + size_t(kb) * l, Z + size_t(kend) * l, 0.0);
+        for (int i = 0; i < m; i++) {
+            const double* a = A + size_t(i) * n;
+            const double* y = Y + size_t(i) * l;
+            for (int k = kb; k < kend; k++) {
+                double* z = Z + size_t(k) * l;
+                for (int r = 0; r < l; r++) z[r] += a[k] * y[r];
+            }
+        }
+    }
+}
+
+//! h[p] = Y[.][p] . Y[.][j], for p <= j, with Y m x l.
+void column_dots(const double* Y, int m, int l, int j, double* h)
+{
+    std::fill(h, h + j + 1, 0.0);
+    #pragma omp parallel for schedule(static) reduction(+:h[:j + 1])
+    for (int i = 0; i < m; i++) {
+        const double* y = Y + size_t(i) * l;
+        for (int p = 0; p <= j; p++) h[p] += y[p] * y[j];
+    }
+}
+
+/**
+ * Make the columns of Y, m x l, orthonormal, by Gram-Schmidt with
+ * reorthogonalization, which goes over the rows of Y rather than down
+ * its columns. Columns that are numerically combinations of the
+ * previous ones are zeroed.
+ */
+void orthonormalize(double* Y, int m, int l)
+{
+    std::vector<double> h(l);
+    for (int j = 0; j < l; j++) {
+        column_dots(Y, m, l, j, h.data());
+        const double before = h[j];
+        double norm = before;
+        for (int pass = 0; pass < 2 and j > 0; pass++) {
+            if (pass > 0) column_dots(Y, m, l, j, h.data());
+            norm = 0;
+            #pragma omp parallel for schedule(static) reduction(+:norm)
+            for (int i = 0; i < m; i++) {
+                double* y = Y + size_t(i) * l;
+                double v = 0;
+                for (int p = 0; p < j; p++) v += y[p] * h[p];
+                y[j] -= v;
+                norm += y[j] * y[j];
+            }
+        }
+        double scale = norm > 1e-20 * before ? 1 / std::sqrt(norm) : 0;
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < m; i++) Y[size_t(i) * l + j] *= scale;
+    }
+}
+
+} // ~namespace
+
+} // ~namespace opencog
+
+int pca_randomized(int nrows, int ncolumns, const double* data,
+                   int ncomponents, int npower, double* coordinates,
+                   double* components, double* w)
+{
+    const int m = nrows, n = ncolumns, k = ncomponents;
+    if (k < 1 or k > std::min(m, n)) return -1;
+    // Oversampling, as advised by Halko, Martinsson and Tropp
+    const int l = std::min(k + 10, std::min(m, n));
+
+    try {
+        // Basis Q, m x l, of the range of A Omega, Omega a gaussian matrix,
+        // refined by power iterations to approach the top singular vectors
+        std::vector<double> Q(size_t(m) * l), Z(size_t(n) * l);
+        xoshiro256pp_x4 rng(randGen().randint());
+        fill_gaussian(Z.data(), Z.size(), 0, 1, rng);
+        multiply(data, m, n, Z.data(), l, Q.data());
+        orthonormalize(Q.data(), m, l);
+        for (int q = 0; q < npower; q++) {
+            multiply_transposed(data, m, n, Q.data(), l, Z.data());
+            orthonormalize(Z.data(), n, l);
+            multiply(data, m, n, Z.data(), l, Q.data());
+            orthonormalize(Q.data(), m, l);
+        }
+
+        // A ~ Q Q^T A; pca of Z = A^T Q, n x l, gives Z = (U S) V^T, so
+        // that A ~ (Q V S) U^T.
+        multiply_transposed(data, m, n, Q.data(), l, Z.data());
+        std::vector<double> V(size_t(l) * l), S(l);
+        std::vector<double*> zrows(n), vrows(l);
+        for (int c = 0; c < n; c++) zrows[c] = &Z[size_t(c) * l];
+        for (int r = 0; r < l; r++) vrows[r] = &V[size_t(r) * l];
+        int error = pca(n, l, zrows.data(), vrows.data(), S.data());
+        if (error) return error;
+
+        for (int j = 0; j < k; j++) {
+            w[j] = S[j];
+            for (int c = 0; c < n; c++)
+                components[size_t(j) * n + c] =
+                    S[j] > 0 ? Z[size_t(c) * l + j] / S[j] : 0;
+        }
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < m; i++)
+            for (int j = 0; j < k; j++) {
+                double c = 0;
+                for (int r = 0; r < l; r++)
+                    c += Q[size_t(i) * l + r] * V[size_t(j) * l + r];
+                coordinates[size_t(i) * k + j] = S[j] * c;
+            }
+        return 0;
+    } catch (const std::bad_alloc&) {
+        return -1;
+    }
+}
@@ -0,0 +1,253 @@
+/*
+ * opencog/util/discrete_sampler.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_DISCRETE_SAMPLER_H
+#define _OPENCOG_DISCRETE_SAMPLER_H
+
+#include <algorithm>
+#include <vector>
+
+#include <opencog/util/oc_assert.h>
+
+namespace opencog
+{
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+//! Walker's alias method, for repeated draws from fixed weights.
+/**
+ * Built in O(n) with Vose's algorithm; each draw then takes O(1),
+ * and a single random double: its integer part picks a column, its
+ * fractional part picks between the column and its alias.
+ *
+ * The generator can be a RandGen or a FastRandGen; anything with
+ * randdouble_one_excluded() will do.
+ */
+class alias_sampler
+{
+public:
+    alias_sampler() {}
+
+    template<typename It>
+    alias_sampler(It from, It to) { build(from, to); }
+
+    explicit alias_sampler(const std::vector<double>& weights)
+    {
+        build(weights.begin(), weights.end());
+    }
+
+    //! (Re)build the table. Weights must be non-negative, with a
+    //! positive sum.
+    template<typename It>
+    void build(It from, It to)
+    {
+        std::vector<double> w(from, to);
+        size_t n = w.size();
+        OC_ASSERT(n > 0, "alias_sampler - no weights");
+        double sum = 0;
+        for (double x : w) {
+            OC_ASSERT(x >= 0, "alias_sampler - negative weight");
+            sum += x;
+        }
+        OC_ASSERT(sum > 0, "alias_sampler - weights sum to zero");
+
+        _prob.assign(n, 1.0);
+        _alias.resize(n);
+        std::vector<unsigned> small, large;
+        for (size_t i = 0; i < n; i++) {
+            _alias[i] = i;
+            w[i] *= n / sum;
+            (w[i] < 1 ? small : large).push_back(i);
+        }
+        while (not small.empty() and not large.empty()) {
+            unsigned s = small.back(), l = large.back();
+            small.pop_back();
+            _prob[s] = w[s];
+            _alias[s] = l;
+            w[l] -= 1 - w[s];
+            if (w[l] < 1) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // What is left has probability 1, up to rounding errors.
+    }
+
+    size_t size() const { return _prob.size(); }
+
+    template<typename Rng>
+    size_t operator()(Rng& rng) const
+    {
+        double x = rng.randdouble_one_excluded() * _prob.size();
+        size_t i = std::min(size_t(x), _prob.size() - 1);
+        return (x - i < _prob[i]) ? i : _alias[i];
+    }
+
+private:
+    std::vector<double> _prob;
+    std::vector<unsigned> _alias;
+};
+
+//! Discrete sampler over weights that change between draws.
+/**
+ * Keeps the weights in a Fenwick (binary indexed) tree, so that
+ * updating a weight, computing a prefix sum and drawing all take
+ * O(log n).
+ *
+ * Draws follow roulette_select exactly: a target t is taken in
+ * [0, total], and the first index whose inclusive prefix sum reaches
+ * t is returned. With integer weights, this reproduces the choices of
+ * roulette_select draw for draw.
+ */
+template<typename W = double>
+class fenwick_sampler
+{
+public:
+    typedef W weight_type;
+
+    fenwick_sampler() : _tree(1, W(0)), _mask(0) {}
+
+    explicit fenwick_sampler(size_t n) { assign(n); }
+
+    template<typename It>
+    fenwick_sampler(It from, It to) { assign(from, to); }
+
+    //! n weights, all zero.
+    void assign(size_t n)
+    {
+        _w.assign(n, W(0));
+        _tree.assign(n + 1, W(0));
+        update_mask_();
+    }
+
+    //! Build in O(n).
+    template<typename It>
+    void assign(It from, It to)
+    {
+        _w.assign(from, to);
+        _tree.assign(_w.size() + 1, W(0));
+        for (size_t i = 1; i <= _w.size(); i++) {
+            _tree[i] += _w[i - 1];
+            size_t j = i + (i & -i);
+            if (j <= _w.size()) _tree[j] += _tree[i];
+        }
+        update_mask_();
+    }
+
+    //! Append a weight, in O(log n).
+    void push_back(W w)
+    {
+        _w.push_back(W(0));
+        size_t i = _w.size();
+        // The new node covers (i - lowbit(i), i]; sum what it covers
+        // so far, all of which are earlier weights.
+        _tree.push_back(prefix_sum(i - 1) - prefix_sum(i - (i & -i)));
+        update_mask_();
+        set(i - 1, w);
+    }
+
+    size_t size() const { return _w.size(); }
+    bool empty() const { return _w.empty(); }
+
+    W weight(size_t i) const { return _w[i]; }
+
+    //! Set the weight of i, in O(log n).
+    void set(size_t i, W w)
+    {
+        add(i, w - _w[i]);
+    }
+
+    //! Add delta to the weight of i, in O(log n).
+    void add(size_t i, W delta)
+    {
+        _w[i] += delta;
+        for (size_t j = i + 1; j < _tree.size(); j += j & -j)
+            _tree[j] += delta;
+    }
+
+    //! Sum of the weights of [0, i).
+    W prefix_sum(size_t i) const
+    {
+        W s(0);
+        for (; i > 0; i -= i & -i) s += _tree[i];
+        return s;
+    }
+
+    W total() const { return prefix_sum(_w.size()); }
+
+    //! Smallest i whose inclusive prefix sum is >= t (0 if t <= 0),
+    //! or size() if t exceeds the total.
+    size_t find(W t) const
+    {
+        if (not (t > W(0))) return 0;
+        size_t pos = 0;
+        for (size_t step = _mask; step > 0; step >>= 1) {
+            size_t next = pos + step;
+            if (next < _tree.size() and _tree[next] < t) {
+                pos = next;
+                t -= _tree[next];
+            }
+        }
+        return pos;
+    }
+
+    //! Draw an index, with probability proportional to its weight.
+    //! The weights must have a positive sum.
+    template<typename Rng>
+    size_t operator()(Rng& rng) const
+    {
+        OC_ASSERT(not empty() and total() > W(0),
+                  "fenwick_sampler - weights sum to zero");
+        size_t i = find(W(double(total()) * rng.randdouble()));
+        return std::min(i, _w.size() - 1);
+    }
+
+    //! Draw an index in [from, size()), as roulette_select does on
+    //! that range.
+    template<typename Rng>
+    size_t operator()(size_t from, Rng& rng) const
+    {
+        OC_ASSERT(from < size(), "fenwick_sampler - empty range");
+        W t = W(double(total() - prefix_sum(from)) * rng.randdouble());
+        if (not (t > W(0))) return from;
+        size_t i = find(t + prefix_sum(from));
+        return std::min(i, _w.size() - 1);
+    }
+
+private:
+    std::vector<W> _w;
+    std::vector<W> _tree;
+    size_t _mask;
+
+    void update_mask_()
+    {
+        _mask = 1;
+        while (_mask <= _w.size()) _mask <<= 1;
+        _mask >>= 1;
+    }
+};
+
+/** @}*/
+} // ~namespace opencog
+
+#endif // _OPENCOG_DISCRETE_SAMPLER_H
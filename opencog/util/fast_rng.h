@@ -0,0 +1,595 @@
+/*
+ * opencog/util/fast_rng.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_FAST_RNG_H
+#define _OPENCOG_FAST_RNG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <opencog/util/oc_assert.h>
+
+/**
+ * \file fast_rng.h
+ *
+ * Small, fast pseudo-random engines, and FastRandGen, a non-virtual
+ * counterpart of RandGen built on top of them.
+ *
+ * RandGen is an abstract class: every draw is a virtual call, and
+ * the engine underneath is a 2.5KB std::mt19937. The engines below
+ * keep 16 to 32 bytes of state, are fully inlinable, and satisfy the
+ * UniformRandomBitGenerator requirements, so they work with the STL
+ * distributions as well.
+ *
+ * - xoshiro256pp: xoshiro256++ (Blackman & Vigna), the default.
+ * - pcg64: PCG XSL-RR 128/64 (O'Neill), where unsigned __int128 exists.
+ * - philox4x32: Philox4x32-10 (Salmon et al.), counter-based, so any
+ *   point of the sequence can be reached in O(1).
+ * - xoshiro256pp_x4: four xoshiro256++ lanes stepped together, for
+ *   filling whole arrays (see the fill_* functions of random.h).
+ */
+
+namespace opencog
+{
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+namespace detail {
+
+inline uint64_t rotl64(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+//! SplitMix64, used to expand a 64-bit seed into a full engine state.
+inline uint64_t splitmix64(uint64_t& x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+} // ~namespace detail
+
+//! xoshiro256++, 256 bits of state, period 2^256 - 1.
+class xoshiro256pp
+{
+public:
+    typedef uint64_t result_type;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max()
+    { return std::numeric_limits<result_type>::max(); }
+
+    explicit xoshiro256pp(uint64_t s = 0) { seed(s); }
+
+    void seed(uint64_t s)
+    {
+        for (uint64_t& w : _s) w = detail::splitmix64(s);
+    }
+
+    result_type operator()()
+    {
+        const uint64_t result = detail::rotl64(_s[0] + _s[3], 23) + _s[0];
+        const uint64_t t = _s[1] << 17;
+        _s[2] ^= _s[0];
+        _s[3] ^= _s[1];
+        _s[1] ^= _s[2];
+        _s[0] ^= _s[3];
+        _s[2] ^= t;
+        _s[3] = detail::rotl64(_s[3], 45);
+        return result;
+    }
+
+    void discard(unsigned long long n) { while (n--) operator()(); }
+
+    //! Advance by 2^128 steps. Jumping n times from one seed gives n
+    //! non-overlapping streams of 2^128 numbers each.
+    void jump()
+    {
+        static const uint64_t poly[4] = {
+            0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+            0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+        jump_(poly);
+    }
+
+    //! Advance by 2^192 steps, i.e. 2^64 jump()s.
+    void long_jump()
+    {
+        static const uint64_t poly[4] = {
+            0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+            0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+        jump_(poly);
+    }
+
+    bool operator==(const xoshiro256pp& o) const
+    {
+        return _s[0] == o._s[0] and _s[1] == o._s[1]
+            and _s[2] == o._s[2] and _s[3] == o._s[3];
+    }
+    bool operator!=(const xoshiro256pp& o) const { return not (*this == o); }
+
+private:
+    uint64_t _s[4];
+
+    void jump_(const uint64_t poly[4])
+    {
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (int i = 0; i < 4; i++)
+            for (int b = 0; b < 64; b++) {
+                if (poly[i] & (uint64_t(1) << b))
+                    for (int k = 0; k < 4; k++) t[k] ^= _s[k];
+                operator()();
+            }
+        for (int k = 0; k < 4; k++) _s[k] = t[k];
+    }
+};
+
+#ifdef __SIZEOF_INT128__
+//! PCG XSL-RR 128/64, the generator known as pcg64.
+/**
+ * Each stream (any odd increment) gives an independent sequence of
+ * period 2^128.
+ */
+class pcg64
+{
+    typedef unsigned __int128 uint128;
+
+    static constexpr uint128 multiplier =
+        (uint128(2549297995355413924ULL) << 64) | 4865540595714422341ULL;
+    static constexpr uint128 default_stream =
+        (uint128(0x5851f42d4c957f2dULL) << 64) | 0x14057b7ef767814fULL;
+
+public:
+    typedef uint64_t result_type;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max()
+    { return std::numeric_limits<result_type>::max(); }
+
+    explicit pcg64(uint64_t s = 0) { seed(s); }
+    pcg64(uint64_t s, uint64_t stream) { seed(s, stream); }
+
+    void seed(uint64_t s)
+    {
+        seed_(s, default_stream);
+    }
+
+    void seed(uint64_t s, uint64_t stream)
+    {
+        seed_(s, (uint128(stream) << 1) | 1u);
+    }
+
+    result_type operator()()
+    {
+        _state = _state * multiplier + _inc;
+        uint64_t x = uint64_t(_state >> 64) ^ uint64_t(_state);
+        unsigned rot = unsigned(_state >> 122);
+        return (x >> rot) | (x << ((64 - rot) & 63));
+    }
+
+    void discard(unsigned long long n) { while (n--) operator()(); }
+
+    bool operator==(const pcg64& o) const
+    {
+        return _state == o._state and _inc == o._inc;
+    }
+    bool operator!=(const pcg64& o) const { return not (*this == o); }
+
+private:
+    uint128 _state;
+    uint128 _inc;
+
+    void seed_(uint64_t s, uint128 inc)
+    {
+        _inc = inc | 1u;
+        _state = 0;
+        _state = _state * multiplier + _inc;
+        _state += s;
+        _state = _state * multiplier + _inc;
+    }
+};
+#endif // __SIZEOF_INT128__
+
+//! Philox4x32-10, a counter-based generator.
+/**
+ * The n-th block of four 32-bit outputs is a pure function of the
+ * 64-bit key (the seed) and the 128-bit counter n, so discard() is
+ * O(1), and streams with distinct keys never overlap. operator()
+ * returns 64 bits, two outputs of a block at a time.
+ */
+class philox4x32
+{
+public:
+    typedef uint64_t result_type;
+    typedef uint32_t block_type[4];
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max()
+    { return std::numeric_limits<result_type>::max(); }
+
+    explicit philox4x32(uint64_t s = 0) { seed(s); }
+    philox4x32(uint64_t s, uint64_t stream) { seed(s, stream); }
+
+    void seed(uint64_t s) { seed(s, 0); }
+
+    //! Key with s, and start the counter at (stream, 0). Each stream
+    //! holds 2^65 outputs before running into the next one.
+    void seed(uint64_t s, uint64_t stream)
+    {
+        _key[0] = uint32_t(s);
+        _key[1] = uint32_t(s >> 32);
+        _ctr[0] = _ctr[1] = 0;
+        _ctr[2] = uint32_t(stream);
+        _ctr[3] = uint32_t(stream >> 32);
+        _pos = 2;
+    }
+
+    //! Compute the block of the given counter and key.
+    static void block(const uint32_t ctr[4], const uint32_t key[2],
+                      block_type out)
+    {
+        uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int r = 0; r < 10; r++) {
+            if (r > 0) {
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+            uint64_t p0 = uint64_t(0xD2511F53u) * c0;
+            uint64_t p1 = uint64_t(0xCD9E8D57u) * c2;
+            uint32_t n0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+            uint32_t n2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+            c1 = uint32_t(p1);
+            c3 = uint32_t(p0);
+            c0 = n0;
+            c2 = n2;
+        }
+        out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+    }
+
+    result_type operator()()
+    {
+        if (2 == _pos) {
+            block(_ctr, _key, _out);
+            increment_();
+            _pos = 0;
+        }
+        uint64_t lo = _out[2 * _pos], hi = _out[2 * _pos + 1];
+        _pos++;
+        return lo | (hi << 32);
+    }
+
+    //! Skip n 64-bit outputs, in O(1).
+    void discard(unsigned long long n)
+    {
+        // Outputs of the current block still to be handed out.
+        unsigned long long left = 2 - _pos;
+        if (n <= left) {
+            _pos += n;
+            return;
+        }
+        n -= left;
+        // _ctr already points past the current block.
+        unsigned long long blocks = n / 2;
+        add_(blocks);
+        _pos = 2;
+        if (n % 2) {
+            block(_ctr, _key, _out);
+            increment_();
+            _pos = 1;
+        }
+    }
+
+    bool operator==(const philox4x32& o) const
+    {
+        for (int i = 0; i < 4; i++)
+            if (_ctr[i] != o._ctr[i]) return false;
+        return _key[0] == o._key[0] and _key[1] == o._key[1]
+            and _pos == o._pos;
+    }
+    bool operator!=(const philox4x32& o) const { return not (*this == o); }
+
+private:
+    uint32_t _ctr[4];
+    uint32_t _key[2];
+    block_type _out;
+    unsigned _pos;
+
+    void increment_() { add_(1); }
+
+    void add_(unsigned long long n)
+    {
+        uint64_t lo = (uint64_t(_ctr[1]) << 32) | _ctr[0];
+        uint64_t sum = lo + n;
+        _ctr[0] = uint32_t(sum);
+        _ctr[1] = uint32_t(sum >> 32);
+        if (sum < lo and 0 == ++_ctr[2]) ++_ctr[3];
+    }
+};
+
+//! Four interleaved xoshiro256++ streams, for bulk generation.
+/**
+ * The lanes are stored side by side, so that generate() advances all
+ * four with the same instructions: with AVX2 one step is a handful of
+ * 256-bit operations, otherwise the plain loop is left for the
+ * compiler to vectorize. Each lane is seeded from its own splitmix64
+ * output, as xoshiro256pp does.
+ *
+ * operator() hands out the same sequence one word at a time, so the
+ * engine can also be used with the STL distributions.
+ */
+class xoshiro256pp_x4
+{
+public:
+    typedef uint64_t result_type;
+    static constexpr unsigned lanes = 4;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max()
+    { return std::numeric_limits<result_type>::max(); }
+
+    explicit xoshiro256pp_x4(uint64_t s = 0) { seed(s); }
+
+    void seed(uint64_t s)
+    {
+        for (auto& w : _s)
+            for (uint64_t& l : w) l = detail::splitmix64(s);
+        _pos = lanes;
+    }
+
+    result_type operator()()
+    {
+        if (lanes == _pos) {
+            step_(_buf);
+            _pos = 0;
+        }
+        return _buf[_pos++];
+    }
+
+    //! Write n random words to out.
+    void generate(uint64_t* out, size_t n)
+    {
+        // Hand out what is left of the buffer first, so that bulk
+        // and single draws make up one sequence.
+        while (n and _pos < lanes) { *out++ = _buf[_pos++]; n--; }
+
+#ifdef __AVX2__
+        __m256i s0 = _mm256_load_si256((const __m256i*)_s[0]),
+            s1 = _mm256_load_si256((const __m256i*)_s[1]),
+            s2 = _mm256_load_si256((const __m256i*)_s[2]),
+            s3 = _mm256_load_si256((const __m256i*)_s[3]);
+        for (; n >= lanes; n -= lanes, out += lanes) {
+            __m256i sum = _mm256_add_epi64(s0, s3);
+            __m256i r = _mm256_add_epi64(
+                _mm256_or_si256(_mm256_slli_epi64(sum, 23),
+                                _mm256_srli_epi64(sum, 41)), s0);
+            _mm256_storeu_si256((__m256i*)out, r);
+            __m256i t = _mm256_slli_epi64(s1, 17);
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45),
+                                 _mm256_srli_epi64(s3, 19));
+        }
+        _mm256_store_si256((__m256i*)_s[0], s0);
+        _mm256_store_si256((__m256i*)_s[1], s1);
+        _mm256_store_si256((__m256i*)_s[2], s2);
+        _mm256_store_si256((__m256i*)_s[3], s3);
+#else
+        for (; n >= lanes; n -= lanes, out += lanes)
+            step_(out);
+#endif
+        if (n) {
+            step_(_buf);
+            _pos = 0;
+            while (n--) *out++ = _buf[_pos++];
+        }
+    }
+
+private:
+    alignas(32) uint64_t _s[4][lanes];
+    uint64_t _buf[lanes];
+    unsigned _pos;
+
+    void step_(uint64_t* out)
+    {
+        for (unsigned l = 0; l < lanes; l++) {
+            uint64_t sum = _s[0][l] + _s[3][l];
+            out[l] = ((sum << 23) | (sum >> 41)) + _s[0][l];
+            uint64_t t = _s[1][l] << 17;
+            _s[2][l] ^= _s[0][l];
+            _s[3][l] ^= _s[1][l];
+            _s[1][l] ^= _s[2][l];
+            _s[0][l] ^= _s[3][l];
+            _s[2][l] ^= t;
+            _s[3][l] = (_s[3][l] << 45) | (_s[3][l] >> 19);
+        }
+    }
+};
+
+/**
+ * Return the thread local xoshiro256pp_x4 instance, used by the bulk
+ * fill_* functions of random.h. Seeded with 0, like randGen().
+ */
+inline xoshiro256pp_x4& bulkRandGen()
+{
+    static thread_local xoshiro256pp_x4 instance(0);
+    return instance;
+}
+
+//! Non-virtual random generator with the interface of RandGen.
+/**
+ * Wraps one of the engines above, and is itself a
+ * UniformRandomBitGenerator, so it can be handed to the STL
+ * distributions. All methods are inline, and none allocates.
+ *
+ * Use it in hot loops instead of RandGen; fastRandGen() gives the
+ * thread-local instance, the way randGen() does for RandGen.
+ */
+template<typename Engine = xoshiro256pp>
+class FastRandGen
+{
+public:
+    typedef Engine engine_type;
+    typedef typename Engine::result_type result_type;
+
+    static constexpr result_type min() { return Engine::min(); }
+    static constexpr result_type max() { return Engine::max(); }
+
+    explicit FastRandGen(uint64_t s = 0) : _engine(s) {}
+
+    void seed(uint64_t s) { _engine.seed(s); }
+    result_type operator()() { return _engine(); }
+    Engine& engine() { return _engine; }
+
+    //! random int between 0 and max rand number.
+    int randint()
+    {
+        return int(_engine() >> 33);
+    }
+
+    //! random float in [0,1]
+    float randfloat()
+    {
+        return float(_engine() >> 40) * (1.0f / float((1u << 24) - 1));
+    }
+
+    //! random double in [0,1]
+    double randdouble()
+    {
+        return double(_engine() >> 11) * (1.0 / double((1ULL << 53) - 1));
+    }
+
+    //! random double in [0,1)
+    double randdouble_one_excluded()
+    {
+        return double(_engine() >> 11) * (1.0 / double(1ULL << 53));
+    }
+
+    //! random int in [0,n)
+    /**
+     * Lemire's multiply-and-shift: unbiased, and a division is only
+     * needed in the rare case where a draw might be rejected.
+     */
+    int randint(int n)
+    {
+        if (n <= 0) return 0;
+        uint64_t range = uint64_t(n);
+        uint64_t m = uint64_t(uint32_t(_engine() >> 32)) * range;
+        uint32_t low = uint32_t(m);
+        if (low < range) {
+            uint32_t threshold = uint32_t(-uint32_t(range)) % uint32_t(range);
+            while (low < threshold) {
+                m = uint64_t(uint32_t(_engine() >> 32)) * range;
+                low = uint32_t(m);
+            }
+        }
+        return int(m >> 32);
+    }
+
+    //! random integer in [0,n), or 0 if n is 0; see randint(n).
+    uint64_t randbounded64(uint64_t n)
+    {
+        if (n == 0) return 0;
+        uint64_t x = _engine();
+#ifdef __SIZEOF_INT128__
+        unsigned __int128 m = (unsigned __int128)x * n;
+        uint64_t low = uint64_t(m);
+        if (low < n) {
+            uint64_t threshold = uint64_t(-n) % n;
+            while (low < threshold) {
+                m = (unsigned __int128)_engine() * n;
+                low = uint64_t(m);
+            }
+        }
+        return m >> 64;
+#else
+        uint64_t threshold = uint64_t(-n) % n;
+        while (x < threshold) x = _engine();
+        return x % n;
+#endif
+    }
+
+    //! return -1 or 1 randonly
+    int rand_positive_negative()
+    {
+        return randbool() ? 1 : -1;
+    }
+
+    //! random boolean
+    bool randbool()
+    {
+        return _engine() >> 63;
+    }
+
+    //! random discrete base on weights
+    /**
+     * A linear scan over the cumulated weights, with no allocation;
+     * for many draws from the same weights, build a
+     * std::discrete_distribution once instead.
+     */
+    int rand_discrete(const std::vector<double>& weights)
+    {
+        OC_ASSERT(not weights.empty(), "FastRandGen::rand_discrete - no weights");
+        double total = 0;
+        for (double w : weights) total += w;
+        double x = randdouble_one_excluded() * total;
+        int last = 0;
+        for (size_t i = 0; i < weights.size(); i++) {
+            if (weights[i] <= 0) continue;
+            last = i;
+            if (x < weights[i]) return i;
+            x -= weights[i];
+        }
+        // Only reached through rounding errors.
+        return last;
+    }
+
+private:
+    Engine _engine;
+};
+
+/**
+ * Return the thread local FastRandGen instance. Like randGen(), each
+ * thread gets its own copy, seeded with 0; use seed() to change it.
+ */
+inline FastRandGen<>& fastRandGen()
+{
+    static thread_local FastRandGen<> instance(0);
+    return instance;
+}
+
+/** @}*/
+} // ~namespace opencog
+
+#endif // _OPENCOG_FAST_RNG_H
@@ -0,0 +1,258 @@
+/*
+ * opencog/util/flat_tree.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_FLAT_TREE_H
+#define _OPENCOG_FLAT_TREE_H
+
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+#include <opencog/util/tree.h>
+
+namespace opencog
+{
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+//! Read-mostly tree (or forest) stored as a contiguous pre-order array.
+/**
+ * Where opencog::tree keeps five pointers per node and scatters nodes
+ * over the heap, flat_tree keeps the node values in pre-order in one
+ * vector, and alongside each one its subtree size (the node itself
+ * included), its arity and the index of its parent. Everything a
+ * traversal needs is then a sequential scan:
+ *
+ * - pre-order is plain index order, begin() to end();
+ * - the first child of i is i+1, and the next sibling of a child c
+ *   is c + subtree_size(c);
+ * - post-order descends to the leftmost leaf, then moves to the next
+ *   sibling's leftmost leaf or up to the parent.
+ *
+ * Node values may be modified in place, but not the shape; to edit
+ * the shape, convert to_tree(), edit, and convert back.
+ *
+ * hash_value() and operator== agree with those of the tree it was
+ * converted from.
+ */
+template<typename T>
+class flat_tree
+{
+public:
+    typedef T value_type;
+    typedef uint32_t index_type;
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    //! Parent index of the roots of the forest.
+    static constexpr index_type npos = index_type(-1);
+
+    flat_tree() {}
+
+    template<typename Alloc>
+    explicit flat_tree(const tree<T, Alloc>& tr)
+    {
+        _data.reserve(tr.size());
+        _size.reserve(tr.size());
+        _arity.reserve(tr.size());
+        _parent.reserve(tr.size());
+        for (auto it = tr.begin(); it != tr.end(); ++it) {
+            append_(it, npos);
+            it.skip_children();
+        }
+    }
+
+    //! Convert back into an opencog::tree.
+    template<typename Alloc = std::allocator<tree_node_<T>>>
+    tree<T, Alloc> to_tree() const
+    {
+        typedef typename tree<T, Alloc>::pre_order_iterator pre_it;
+        tree<T, Alloc> tr;
+        std::vector<pre_it> nodes(size());
+        for (index_type i = 0; i < size(); i++) {
+            if (npos == _parent[i])
+                nodes[i] = tr.insert(tr.end(), _data[i]);
+            else
+                nodes[i] = tr.append_child(nodes[_parent[i]], _data[i]);
+        }
+        return tr;
+    }
+
+    index_type size() const { return _data.size(); }
+    bool empty() const { return _data.empty(); }
+
+    T& operator[](index_type i) { return _data[i]; }
+    const T& operator[](index_type i) const { return _data[i]; }
+
+    //! Pre-order iteration over node values.
+    iterator begin() { return _data.begin(); }
+    iterator end() { return _data.end(); }
+    const_iterator begin() const { return _data.begin(); }
+    const_iterator end() const { return _data.end(); }
+
+    //! Number of nodes in the subtree rooted at i, i included.
+    index_type subtree_size(index_type i) const { return _size[i]; }
+    //! Number of children of i.
+    index_type arity(index_type i) const { return _arity[i]; }
+    //! Parent of i, or npos if i is a root.
+    index_type parent(index_type i) const { return _parent[i]; }
+    bool is_leaf(index_type i) const { return 1 == _size[i]; }
+
+    //! One past the last node of the subtree rooted at i.
+    index_type subtree_end(index_type i) const { return i + _size[i]; }
+
+    //! Iterates over the indices of a sequence of siblings.
+    class sibling_iterator
+    {
+        const index_type* _sizes;
+        index_type _i;
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef index_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const index_type* pointer;
+        typedef const index_type& reference;
+
+        sibling_iterator(const index_type* sizes, index_type i)
+            : _sizes(sizes), _i(i) {}
+        index_type operator*() const { return _i; }
+        sibling_iterator& operator++() { _i += _sizes[_i]; return *this; }
+        sibling_iterator operator++(int)
+        {
+            sibling_iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const sibling_iterator& o) const { return _i == o._i; }
+        bool operator!=(const sibling_iterator& o) const { return _i != o._i; }
+    };
+
+    //! A [begin, end) range of sibling indices.
+    struct sibling_range
+    {
+        sibling_iterator first, last;
+        sibling_iterator begin() const { return first; }
+        sibling_iterator end() const { return last; }
+    };
+
+    //! Indices of the children of i.
+    sibling_range children(index_type i) const
+    {
+        return {sibling_iterator(_size.data(), i + 1),
+                sibling_iterator(_size.data(), subtree_end(i))};
+    }
+
+    //! Indices of the roots of the forest.
+    sibling_range roots() const
+    {
+        return {sibling_iterator(_size.data(), 0),
+                sibling_iterator(_size.data(), size())};
+    }
+
+    //! Iterates over node indices in post-order.
+    class post_order_iterator
+    {
+        const flat_tree* _tr;
+        index_type _i;
+
+        index_type leftmost_leaf(index_type i) const
+        {
+            while (not _tr->is_leaf(i)) i++;
+            return i;
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef index_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const index_type* pointer;
+        typedef const index_type& reference;
+
+        post_order_iterator(const flat_tree* tr, index_type i)
+            : _tr(tr), _i(i < tr->size() ? leftmost_leaf(i) : i) {}
+
+        index_type operator*() const { return _i; }
+
+        post_order_iterator& operator++()
+        {
+            index_type p = _tr->_parent[_i];
+            index_type next = _tr->subtree_end(_i);
+            index_type bound = (npos == p) ? _tr->size() : _tr->subtree_end(p);
+            if (next < bound)
+                _i = leftmost_leaf(next);
+            else
+                _i = (npos == p) ? _tr->size() : p;
+            return *this;
+        }
+        post_order_iterator operator++(int)
+        {
+            post_order_iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const post_order_iterator& o) const { return _i == o._i; }
+        bool operator!=(const post_order_iterator& o) const { return _i != o._i; }
+    };
+
+    post_order_iterator begin_post() const { return post_order_iterator(this, 0); }
+    post_order_iterator end_post() const { return post_order_iterator(this, size()); }
+
+    bool operator==(const flat_tree& o) const
+    {
+        return _size == o._size and _data == o._data;
+    }
+    bool operator!=(const flat_tree& o) const { return not (*this == o); }
+
+private:
+    std::vector<T> _data;
+    std::vector<index_type> _size;
+    std::vector<index_type> _arity;
+    std::vector<index_type> _parent;
+
+    template<typename It>
+    void append_(const It& it, index_type parent)
+    {
+        index_type i = _data.size();
+        _data.push_back(*it);
+        _size.push_back(1);
+        _arity.push_back(it.number_of_children());
+        _parent.push_back(parent);
+        for (auto c = it.begin(); c != it.end(); ++c)
+            append_(c, i);
+        _size[i] = _data.size() - i;
+    }
+};
+
+//! Same value as hash_value() of the opencog::tree it came from.
+template<typename T>
+std::size_t hash_value(const flat_tree<T>& tr)
+{
+    return boost::hash_range(tr.begin(), tr.end());
+}
+
+/** @}*/
+} // ~namespace opencog
+
+#endif // _OPENCOG_FLAT_TREE_H
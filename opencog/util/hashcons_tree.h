@@ -0,0 +1,231 @@
+/*
+ * opencog/util/hashcons_tree.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_HASHCONS_TREE_H
+#define _OPENCOG_HASHCONS_TREE_H
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+#include <opencog/util/oc_assert.h>
+#include <opencog/util/tree.h>
+
+namespace opencog
+{
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+template<typename T, typename Hash, typename Equal> class hc_table;
+
+//! Immutable, uniquely-represented tree node; see hc_table.
+template<typename T>
+class hc_node
+{
+    template<typename, typename, typename> friend class hc_table;
+
+    T _data;
+    std::vector<const hc_node*> _children;
+    size_t _hash;
+    size_t _size;
+
+    hc_node(const T& data, const std::vector<const hc_node*>& children,
+            size_t hash)
+        : _data(data), _children(children), _hash(hash), _size(1)
+    {
+        for (const hc_node* c : _children) _size += c->_size;
+    }
+
+public:
+    const T& data() const { return _data; }
+    size_t arity() const { return _children.size(); }
+    const hc_node* child(size_t i) const { return _children[i]; }
+    const std::vector<const hc_node*>& children() const { return _children; }
+
+    //! Structural (Merkle) hash, computed once at construction.
+    size_t hash() const { return _hash; }
+
+    //! Number of nodes of the tree, counting shared subtrees each time
+    //! they occur, i.e. the size the equivalent opencog::tree has.
+    size_t size() const { return _size; }
+};
+
+//! Handle on an immutable, hash-consed tree.
+/**
+ * A thin wrapper around a pointer into an hc_table, so copying is
+ * O(1), and since the table stores each distinct subtree exactly
+ * once, two handles from the same table are structurally equal iff
+ * they point to the same node: equality is O(1) as well.
+ */
+template<typename T>
+class hc_tree
+{
+    const hc_node<T>* _root;
+
+public:
+    typedef T value_type;
+
+    hc_tree(const hc_node<T>* root = nullptr) : _root(root) {}
+
+    bool empty() const { return nullptr == _root; }
+    const hc_node<T>* root() const { return _root; }
+    const hc_node<T>* operator->() const { return _root; }
+    const hc_node<T>& operator*() const { return *_root; }
+
+    const T& data() const { return _root->data(); }
+    size_t arity() const { return _root->arity(); }
+    hc_tree child(size_t i) const { return _root->child(i); }
+    size_t size() const { return empty() ? 0 : _root->size(); }
+
+    bool operator==(const hc_tree& o) const { return _root == o._root; }
+    bool operator!=(const hc_tree& o) const { return _root != o._root; }
+
+    //! Convert into a mutable opencog::tree.
+    template<typename Alloc = std::allocator<tree_node_<T>>>
+    tree<T, Alloc> to_tree() const
+    {
+        tree<T, Alloc> tr;
+        if (empty()) return tr;
+        append_(tr, tr.set_head(_root->data()), _root);
+        return tr;
+    }
+
+private:
+    template<typename Tree, typename It>
+    static void append_(Tree& tr, It it, const hc_node<T>* n)
+    {
+        for (const hc_node<T>* c : n->children())
+            append_(tr, tr.append_child(it, c->data()), c);
+    }
+};
+
+template<typename T>
+std::size_t hash_value(const hc_tree<T>& t)
+{
+    return t.empty() ? 0 : t->hash();
+}
+
+//! Table of hash-consed trees.
+/**
+ * Every distinct subtree is stored once: make() and intern() first
+ * look the subtree up by its structural hash, and only allocate a
+ * node if it is not already in the table. Large populations of
+ * similar trees (e.g. candidates that share most of their subtrees)
+ * then cost little more than their differences.
+ *
+ * All nodes are owned by the table and freed with it; handles must
+ * not outlive the table they come from, and handles from different
+ * tables must not be compared. Interning takes a lock, so a single
+ * table may be shared between threads; reading a tree does not.
+ */
+template<typename T,
+         typename Hash = boost::hash<T>,
+         typename Equal = std::equal_to<T>>
+class hc_table
+{
+    typedef hc_node<T> node;
+
+    // Keyed by structural hash, so that a hit needs no allocation.
+    std::unordered_multimap<size_t, node*> _nodes;
+    mutable std::mutex _mtx;
+
+public:
+    hc_table() {}
+    hc_table(const hc_table&) = delete;
+    hc_table& operator=(const hc_table&) = delete;
+
+    ~hc_table()
+    {
+        for (auto& hn : _nodes) delete hn.second;
+    }
+
+    //! Number of distinct nodes stored.
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _nodes.size();
+    }
+
+    //! Return the unique tree with the given root and children.
+    hc_tree<T> make(const T& data,
+                    const std::vector<hc_tree<T>>& children = {})
+    {
+        std::vector<const node*> kids;
+        kids.reserve(children.size());
+        for (const hc_tree<T>& c : children) {
+            OC_ASSERT(not c.empty(), "hc_table::make - empty child");
+            kids.push_back(c.root());
+        }
+        return make_(data, kids);
+    }
+
+    //! Intern the subtree of an opencog::tree rooted at it.
+    template<typename It>
+    hc_tree<T> intern(It it)
+    {
+        std::vector<const node*> kids;
+        kids.reserve(it.number_of_children());
+        for (auto c = it.begin(); c != it.end(); ++c)
+            kids.push_back(intern(c).root());
+        return make_(*it, kids);
+    }
+
+    //! Intern an opencog::tree, which must have a single root.
+    template<typename Alloc>
+    hc_tree<T> intern(const tree<T, Alloc>& tr)
+    {
+        if (tr.empty()) return hc_tree<T>();
+        OC_ASSERT(tr.number_of_siblings(tr.begin()) == 0,
+                  "hc_table::intern - forests are not supported");
+        return intern(tr.begin());
+    }
+
+private:
+    hc_tree<T> make_(const T& data, std::vector<const node*>& kids)
+    {
+        size_t h = Hash()(data);
+        boost::hash_combine(h, kids.size());
+        for (const node* c : kids) boost::hash_combine(h, c->hash());
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto range = _nodes.equal_range(h);
+        for (auto it = range.first; it != range.second; ++it) {
+            // Children are already unique, so comparing their
+            // addresses is a complete structural comparison.
+            const node* n = it->second;
+            if (n->children() == kids and Equal()(n->data(), data))
+                return n;
+        }
+        node* n = new node(data, kids, h);
+        _nodes.emplace(h, n);
+        return n;
+    }
+};
+
+/** @}*/
+} // ~namespace opencog
+
+#endif // _OPENCOG_HASHCONS_TREE_H
@@ -64,12 +64,27 @@ struct deref_equals {
     Equals equals;
 };
 
-template<typename T>
-std::size_t hash_value(const tree<T>& tr)
+template<typename T, typename Alloc>
+std::size_t hash_value(const tree<T, Alloc>& tr)
 {
     return boost::hash_range(tr.begin(), tr.end());
 }
 
+//! Hash functor using the tree's cached, Merkle-style subtree hash.
+/**
+ * Unlike hash_value(), which hashes every node on each call, this
+ * only re-hashes what changed since the last call, on a hashed_tree
+ * (see tree::hash()).
+ * The two functors return different values, so don't mix them on the
+ * same container.
+ */
+struct cached_tree_hash {
+    template<typename T, typename Alloc>
+    size_t operator()(const tree<T, Alloc>& tr) const {
+        return tr.hash();
+    }
+};
+
 //! Functor comparing the addresses of objects pointed by
 //! tree iterators.
 /**
@@ -0,0 +1,374 @@
+/*
+ * opencog/util/hnsw.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_HNSW_H
+#define _OPENCOG_HNSW_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <opencog/util/mt19937ar.h>
+#include <opencog/util/oc_assert.h>
+
+/**
+ * \file hnsw.h
+ *
+ * Approximate nearest neighbor search.
+ */
+
+namespace opencog
+{
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+//! Hierarchical navigable small world graph (Malkov and Yashunin).
+/**
+ * An approximate counterpart of CoverTree, for the same points: Point
+ * must provide double Point::distance(const Point&) const, a metric
+ * (or close to it; the triangle inequality is not relied upon).
+ *
+ * Each point is a node of a graph linked to about M of its near
+ * neighbors, and the nodes are sorted into layers of exponentially
+ * decreasing sizes, each layer a graph of its own. A query walks
+ * greedily down from the top layer, then searches the bottom one
+ * keeping the ef nearest nodes met. Queries cost about
+ * O(M ef log n) distances whatever the dimension, but may miss some
+ * of the true nearest neighbors; a larger ef (or M) finds more of
+ * them, at the cost of speed.
+ *
+ * Points are added one at a time, and never removed. Unlike CoverTree,
+ * equal points are all kept. Queries may run concurrently with each
+ * other, but not with insertions.
+ */
+template<class Point>
+class hnsw_index
+{
+public:
+    typedef uint32_t index_type;
+
+    /**
+     * M is the number of links of a node per layer (twice as many in
+     * the bottom layer), and ef_construction the breadth of the
+     * searches finding them; ef is the default breadth of queries.
+     * seed seeds the choice of the layers of the nodes.
+     */
+    hnsw_index(unsigned M = 16, unsigned ef_construction = 200,
+               unsigned ef = 50, unsigned long seed = 0)
+        : _M(M), _M0(2 * M), _efConstruction(ef_construction), _ef(ef),
+          _mL(1.0 / std::log(double(std::max(M, 2u)))),
+          _entry(0), _maxLevel(-1), _rng(seed)
+    {
+        OC_ASSERT(M >= 2, "hnsw_index - M must be at least 2");
+        OC_ASSERT(ef_construction > 0 and ef > 0,
+                  "hnsw_index - ef must be positive");
+    }
+
+    /**
+     * Add p, and return its index.
+     */
+    index_type insert(const Point& p);
+
+    //! Add all points, in order.
+    void insert(const std::vector<Point>& points)
+    {
+        for (const Point& p : points) insert(p);
+    }
+
+    /**
+     * Returns the (approximately) k nearest points to p, nearest
+     * first, searching with breadth ef (or ef() if 0).
+     */
+    std::vector<Point> k_nearest_neighbors(const Point& p, unsigned k,
+                                           unsigned ef = 0) const;
+
+    /**
+     * Same as above, but sets out to the distances and indices of
+     * the neighbors. Once out and the buffers of the thread have
+     * grown enough, this allocates no memory.
+     */
+    void k_nearest_neighbors(const Point& p, unsigned k, unsigned ef,
+                             std::vector<std::pair<double, index_type>>& out)
+        const;
+
+    unsigned ef() const { return _ef; }
+    void set_ef(unsigned ef)
+    {
+        OC_ASSERT(ef > 0, "hnsw_index - ef must be positive");
+        _ef = ef;
+    }
+    unsigned M() const { return _M; }
+
+    size_t size() const { return _points.size(); }
+    bool empty() const { return _points.empty(); }
+    const Point& operator[](index_type i) const { return _points[i]; }
+
+private:
+    typedef std::pair<double, index_type> distIndex;
+    typedef std::vector<distIndex> heap_type;
+
+    unsigned _M, _M0, _efConstruction, _ef;
+    double _mL;
+
+    std::vector<Point> _points;
+    //top layer of each node
+    std::vector<int> _level;
+    //links of node n in the bottom layer: a count, then _M0 slots,
+    //from _links0[n * (_M0 + 1)]
+    std::vector<index_type> _links0;
+    //links of node n in layer l > 0, the same way with _M slots,
+    //from _links[n][(l - 1) * (_M + 1)]
+    std::vector<std::vector<index_type>> _links;
+
+    index_type _entry;
+    int _maxLevel;
+    MT19937RandGen _rng;
+
+    //Buffers of the searches of a thread
+    struct scratch {
+        //node n was visited by the current search iff mark[n] == epoch
+        std::vector<unsigned> mark;
+        unsigned epoch = 0;
+        heap_type candidates, results, selected;
+    };
+    static scratch& thread_scratch()
+    {
+        static thread_local scratch s;
+        return s;
+    }
+
+    const index_type* links(index_type n, int layer) const
+    {
+        return layer == 0 ? &_links0[size_t(n) * (_M0 + 1)]
+            : &_links[n][size_t(layer - 1) * (_M + 1)];
+    }
+    index_type* links(index_type n, int layer)
+    {
+        return const_cast<index_type*>(
+            static_cast<const hnsw_index*>(this)->links(n, layer));
+    }
+    unsigned max_links(int layer) const { return layer == 0 ? _M0 : _M; }
+
+    //Walk from entry to a local minimum of the distance to p, in layer.
+    void greedy_search(const Point& p, int layer,
+                       distIndex& entry) const;
+
+    /**
+     * Set results to the ef nearest nodes to p found in layer by a
+     * best first search from entry, as a max-heap.
+     */
+    void search_layer(const Point& p, const distIndex& entry, unsigned ef,
+                      int layer, scratch& buf) const;
+
+    /**
+     * Keep at most m of the candidates (sorted by increasing distance
+     * to their base node), by the heuristic of the paper: a candidate
+     * is dropped if it is nearer to an already kept one than to the
+     * base node, so that links go in diverse directions.
+     */
+    void select_neighbors(heap_type& candidates, unsigned m) const;
+
+    //Add a link from n to m in layer, pruning n's links if full.
+    void connect(index_type n, index_type m, double d, int layer);
+};
+
+template<class Point>
+typename hnsw_index<Point>::index_type
+hnsw_index<Point>::insert(const Point& p)
+{
+    OC_ASSERT(_points.size() < size_t(UINT32_MAX),
+              "hnsw_index - too many points");
+    index_type n = _points.size();
+    int level = int(-std::log(1.0 - _rng.randdouble_one_excluded()) * _mL);
+    _points.push_back(p);
+    _level.push_back(level);
+    _links0.resize(_links0.size() + _M0 + 1, 0);
+    _links.emplace_back(size_t(level) * (_M + 1), 0);
+    if (_maxLevel < 0) {
+        _entry = n;
+        _maxLevel = level;
+        return n;
+    }
+
+    scratch& buf = thread_scratch();
+    distIndex entry(p.distance(_points[_entry]), _entry);
+    for (int l = _maxLevel; l > level; l--)
+        greedy_search(p, l, entry);
+    for (int l = std::min(level, _maxLevel); l >= 0; l--) {
+        search_layer(p, entry, _efConstruction, l, buf);
+        buf.selected = buf.results;
+        std::sort_heap(buf.selected.begin(), buf.selected.end());
+        entry = buf.selected.front();
+        select_neighbors(buf.selected, _M);
+        index_type* nl = links(n, l);
+        nl[0] = buf.selected.size();
+        for (size_t i = 0; i < buf.selected.size(); i++)
+            nl[i + 1] = buf.selected[i].second;
+        for (size_t i = 0; i < buf.selected.size(); i++)
+            connect(buf.selected[i].second, n, buf.selected[i].first, l);
+    }
+    if (level > _maxLevel) {
+        _entry = n;
+        _maxLevel = level;
+    }
+    return n;
+}
+
+template<class Point>
+void hnsw_index<Point>::greedy_search(const Point& p, int layer,
+                                      distIndex& entry) const
+{
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        const index_type* l = links(entry.second, layer);
+        for (index_type i = 1; i <= l[0]; i++) {
+            double d = p.distance(_points[l[i]]);
+            if (d < entry.first) {
+                entry = distIndex(d, l[i]);
+                changed = true;
+            }
+        }
+    }
+}
+
+template<class Point>
+void hnsw_index<Point>::search_layer(const Point& p, const distIndex& entry,
+                                     unsigned ef, int layer,
+                                     scratch& buf) const
+{
+    if (buf.mark.size() < _points.size())
+        buf.mark.resize(_points.size(), 0);
+    if (++buf.epoch == 0) {
+        std::fill(buf.mark.begin(), buf.mark.end(), 0);
+        buf.epoch = 1;
+    }
+    // candidates is a min-heap, results a max-heap
+    std::greater<distIndex> greater;
+    heap_type& candidates = buf.candidates;
+    heap_type& results = buf.results;
+    candidates.assign(1, entry);
+    results.assign(1, entry);
+    buf.mark[entry.second] = buf.epoch;
+    while (not candidates.empty()) {
+        distIndex c = candidates.front();
+        if (c.first > results.front().first) break;
+        std::pop_heap(candidates.begin(), candidates.end(), greater);
+        candidates.pop_back();
+        const index_type* l = links(c.second, layer);
+        for (index_type i = 1; i <= l[0]; i++) {
+            index_type m = l[i];
+            if (buf.mark[m] == buf.epoch) continue;
+            buf.mark[m] = buf.epoch;
+            double d = p.distance(_points[m]);
+            if (results.size() < ef or d < results.front().first) {
+                candidates.push_back(distIndex(d, m));
+                std::push_heap(candidates.begin(), candidates.end(), greater);
+                results.push_back(distIndex(d, m));
+                std::push_heap(results.begin(), results.end());
+                if (results.size() > ef) {
+                    std::pop_heap(results.begin(), results.end());
+                    results.pop_back();
+                }
+            }
+        }
+    }
+}
+
+template<class Point>
+void hnsw_index<Point>::select_neighbors(heap_type& candidates,
+                                         unsigned m) const
+{
+    if (candidates.size() <= m) return;
+    size_t kept = 0;
+    for (size_t i = 0; i < candidates.size() and kept < m; i++) {
+        const Point& c = _points[candidates[i].second];
+        bool good = true;
+        for (size_t j = 0; j < kept and good; j++)
+            good = c.distance(_points[candidates[j].second])
+                > candidates[i].first;
+        if (good) candidates[kept++] = candidates[i];
+    }
+    candidates.resize(kept);
+}
+
+template<class Point>
+void hnsw_index<Point>::connect(index_type n, index_type m, double d,
+                                int layer)
+{
+    index_type* l = links(n, layer);
+    unsigned max = max_links(layer);
+    if (l[0] < max) {
+        l[++l[0]] = m;
+        return;
+    }
+    // Full: choose among the old links and the new one.
+    heap_type ls;
+    ls.reserve(max + 1);
+    ls.push_back(distIndex(d, m));
+    const Point& p = _points[n];
+    for (index_type i = 1; i <= l[0]; i++)
+        ls.push_back(distIndex(p.distance(_points[l[i]]), l[i]));
+    std::sort(ls.begin(), ls.end());
+    select_neighbors(ls, max);
+    l[0] = ls.size();
+    for (size_t i = 0; i < ls.size(); i++) l[i + 1] = ls[i].second;
+}
+
+template<class Point>
+void hnsw_index<Point>::k_nearest_neighbors(
+    const Point& p, unsigned k, unsigned ef,
+    std::vector<std::pair<double, index_type>>& out) const
+{
+    out.clear();
+    if (_maxLevel < 0 or k == 0) return;
+    scratch& buf = thread_scratch();
+    distIndex entry(p.distance(_points[_entry]), _entry);
+    for (int l = _maxLevel; l > 0; l--)
+        greedy_search(p, l, entry);
+    search_layer(p, entry, std::max(ef ? ef : _ef, k), 0, buf);
+    std::sort_heap(buf.results.begin(), buf.results.end());
+    out.assign(buf.results.begin(),
+               buf.results.begin() + std::min<size_t>(k, buf.results.size()));
+}
+
+template<class Point>
+std::vector<Point> hnsw_index<Point>::k_nearest_neighbors(const Point& p,
+                                                          unsigned k,
+                                                          unsigned ef) const
+{
+    std::vector<std::pair<double, index_type>> out;
+    k_nearest_neighbors(p, k, ef, out);
+    std::vector<Point> res;
+    res.reserve(out.size());
+    for (const auto& di : out) res.push_back(_points[di.second]);
+    return res;
+}
+
+/** @}*/
+} // ~namespace opencog
+
+#endif // _OPENCOG_HNSW_H
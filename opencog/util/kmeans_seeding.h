@@ -0,0 +1,84 @@
+/*
+ * opencog/util/kmeans_seeding.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_KMEANS_SEEDING_H
+#define _OPENCOG_KMEANS_SEEDING_H
+
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <vector>
+
+namespace opencog
+{
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+//! k-means++ seeding (Arthur and Vassilvitskii, 2007) of k of n items.
+/**
+ * The first seed is drawn uniformly, and each next one among the
+ * items not drawn yet, with a probability proportional to the least
+ * weight(i, j) of item i over the seeds j drawn so far; for k-means,
+ * weight is the squared distance. seed(j, s) is called when item s is
+ * drawn as seed j, before weight(., j).
+ *
+ * Requires 1 <= k <= n, and a generator providing randint(n) and
+ * randdouble_one_excluded().
+ */
+template<typename Rng, typename Seed, typename Weight>
+void kmeans_pp_seeding(size_t n, int k, Rng& rng, Seed seed, Weight weight)
+{
+    std::vector<double> nearest(n, DBL_MAX);
+    std::vector<char> chosen(n, 0);
+    size_t s = rng.randint(n);
+    for (int j = 0;; j++) {
+        chosen[s] = 1;
+        seed(j, s);
+        if (j + 1 == k) break;
+
+        double total = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (chosen[i]) continue;
+            nearest[i] = std::min(nearest[i], double(weight(i, j)));
+            total += nearest[i];
+        }
+        // If there are fewer distinct items than seeds, the remaining
+        // seeds are drawn uniformly.
+        double r = rng.randdouble_one_excluded() * total;
+        size_t left = rng.randint(n - j - 1), last = 0;
+        for (s = 0; s < n; s++) {
+            if (chosen[s]) continue;
+            if (total > 0) {
+                if (nearest[s] <= 0) continue;
+                last = s;
+                if ((r -= nearest[s]) < 0) break;
+            } else if (left-- == 0) break;
+        }
+        if (s == n) s = last;
+    }
+}
+
+/** @}*/
+} // ~namespace opencog
+
+#endif // _OPENCOG_KMEANS_SEEDING_H
@@ -27,7 +27,7 @@ namespace opencog
 
 unsigned int lazy_normal_selector::select()
 {
-    return _s;
+    return (_l <= _s and _s < _u) ? _s : _l;
 }
 
 } //~namespace opencog
@@ -25,7 +25,6 @@
 
 #include <opencog/util/lazy_selector.h>
 #include <opencog/util/oc_assert.h>
-#include <functional>
 
 namespace opencog
 {
@@ -46,11 +45,8 @@ struct lazy_normal_selector : public lazy_selector {
         OC_ASSERT(s < n);
     }
 protected:
-    unsigned int select() override {
-        cassert(_selected_indices.size() < n,
-                "lazy_normal_selector - All elements have been selected.");
-        return _selected_indices.size();
-    }
+    //! _s while it is free, else the lowest free position
+    unsigned int select() override;
 private:
     unsigned int _s;
 };
@@ -35,7 +35,7 @@ lazy_random_selector::lazy_random_selector(unsigned int u, unsigned int l,
 
 unsigned int lazy_random_selector::select()
 {
-    return rng.randint(_u);
+    return _l + rng.randbounded32(_u - _l);
 }
 
 } //~namespace opencog
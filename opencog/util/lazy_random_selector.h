@@ -45,7 +45,7 @@ struct lazy_random_selector : public lazy_selector {
     lazy_random_selector(unsigned int u, unsigned int l,
                          opencog::RandGen& _rng = randGen());
 protected:
-    unsigned int select();
+    unsigned int select() override;
 private:
     opencog::RandGen& rng;
 };
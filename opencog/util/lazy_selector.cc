@@ -23,23 +23,16 @@
  */
 
 #include "lazy_selector.h"
-#include "exceptions.h"
 #include "oc_assert.h"
-#include <iostream>
-#include <iterator>
 #include <algorithm>
-#include <functional>
-#include <vector>
-#include <boost/bind/bind.hpp>
-#include <boost/iterator/counting_iterator.hpp>
 
 namespace opencog
 {
 
 lazy_selector::lazy_selector(unsigned int u, unsigned int l)
-    : _u(u), _l(l)
+    : _u(u), _l(l), _lower(l)
 {
-    OC_ASSERT(u - l > 0, "you cannot select any thing from an empty list");
+    OC_ASSERT(u > l, "you cannot select any thing from an empty list");
 }
 
 bool lazy_selector::empty() const
@@ -49,63 +42,83 @@ bool lazy_selector::empty() const
 
 unsigned int lazy_selector::count_n_free() const
 {
-    return std::count_if(
-                    boost::counting_iterator<unsigned int>(_l),
-                    boost::counting_iterator<unsigned int>(_u),
-                    boost::bind(&lazy_selector::is_free, this, boost::placeholders::_1));
+    return empty() ? 0 : _u - _l;
 }
 
-void lazy_selector::reset_range(unsigned int new_n) {
-    cassert(new_n > 0, "lazy_selector - n must be > 0.");
-    n = new_n;
-    _selected_indices.clear();
+void lazy_selector::reset_range(unsigned int new_u)
+{
+    reset_range(new_u, _lower);
 }
 
+/**
+ * Growing the upper bound only appends positions holding themselves,
+ * none of which has been selected, so that is done in O(1). Otherwise
+ * the virtual array is rebuilt over [new_l,new_u), and the numbers of
+ * that range already selected are taken out of it again, as
+ * operator() does, in O(k).
+ */
 void lazy_selector::reset_range(unsigned int new_u, unsigned int new_l)
 {
-	OC_ASSERT(new_l >= _l,
-	          "You cannot reset the lower bound by a lower number, "
-	          "due to the workings of the algorithm.");
-    _u = new_u;
+    if (new_l == _lower and new_u >= _u) {
+        _u = new_u;
+        return;
+    }
+
+    _lower = new_l;
     _l = new_l;
+    _u = std::max(new_u, new_l);
+    _moved.clear();
+
+    // Position of the numbers not at their own position.
+    std::unordered_map<unsigned int, unsigned int> pos_of;
+    for (unsigned int v : _picked) {
+        if (v < new_l or v >= _u) continue;
+        auto it = pos_of.find(v);
+        unsigned int pos = it == pos_of.end() ? v : it->second;
+        if (pos != _l) {
+            unsigned int lv = at(_l);
+            place(pos, lv);
+            pos_of[lv] = pos;
+        }
+        _moved.erase(_l);
+        pos_of.erase(v);
+        _l++;
+    }
 }
 
 /**
  * returns the selected number (never twice the same)
  *
- * It works by creating a mapping between already selected indices and
- * free indices (never selected yet).
- *
- * To chose the free indices, we use an index _l, that
- * goes from the lower range to the upper range and only corresponds to
- * free indices. So every time _l corresponds to a non free index
- * it is incremented until it gets to a free index.
- *
+ * The number at the position chosen by select() is returned, and
+ * the number at _l takes its place, as _l moves past it.
  */
 unsigned int lazy_selector::operator()()
 {
-    cassert(_selected_indices.size() < n, 
-            "lazy_selector - All elements have been selected.");
-    unsigned int sel_idx = select();
-    _selected_indices.insert(sel_idx);
-    return sel_idx;
+    OC_ASSERT(!empty(), "lazy_selector - All elements have been selected.");
+    unsigned int pos = select();
+    OC_ASSERT(_l <= pos and pos < _u,
+              "lazy_selector - select() out of [_l,_u).");
+    unsigned int res = at(pos);
+    if (pos != _l)
+        place(pos, at(_l));
+    _moved.erase(_l);
+    _l++;
+    _picked.insert(res);
+    return res;
 }
 
-bool lazy_selector::is_free(unsigned int idx) const
+unsigned int lazy_selector::at(unsigned int pos) const
 {
-    return _picked.find(idx) == _picked.end();
+    auto it = _moved.find(pos);
+    return it == _moved.end() ? pos : it->second;
 }
 
-void lazy_selector::increase_l_till_free()
+void lazy_selector::place(unsigned int pos, unsigned int val)
 {
-    do {
-        _l++;
-    } while(!is_free(_l));
-}
-
-bool lazy_selector::is_still_free(unsigned int idx) const {
-    cassert(idx < n, "lazy_selector - Index greater than n.");
-    return _selected_indices.find(idx) == _selected_indices.end();
+    if (pos == val)
+        _moved.erase(pos);
+    else
+        _moved[pos] = val;
 }
 
 } //~namespace opencog
@@ -25,9 +25,8 @@
 #ifndef _OPENCOG_LAZY_SELECTOR_H
 #define _OPENCOG_LAZY_SELECTOR_H
 
+#include <unordered_map>
 #include <unordered_set>
-#include <functional>
-#include <cassert>
 
 namespace opencog
 {
@@ -39,6 +38,14 @@ namespace opencog
  * That class allows to select integers in [l,u) but never select
  * twice the same.  When the operator is called more than u-l times an
  * assertion is raised.
+ *
+ * It is a sparse Fisher-Yates shuffle: the integers still free are
+ * kept, in some order, at the positions [_l,_u) of a virtual array
+ * that starts as the identity. select() picks a position in [_l,_u),
+ * its value is returned and replaced by the value at _l, then _l is
+ * incremented. Only the positions holding something else than
+ * themselves are stored, in a hash map, so each selection takes O(1)
+ * and k selections use O(k) memory, whatever u-l is.
  */
 class lazy_selector
 {	
@@ -47,42 +54,43 @@ public:
     virtual ~lazy_selector() {}
     bool empty() const;
 
-    //! returns the number of elements < _n that can still be chosen
+    //! returns the number of elements in [l,u) that can still be chosen
     unsigned int count_n_free() const;
 
     //! returns the selected number (never twice the same)
     unsigned int operator()();
 
-    //! reset upper or lower bound. Note that given the way the
-    //! algorithm works (by increasing the lower bound to never get
-    //! the twice the same number), you can never reset the lower
-    //! bound by a lower number
+    //! reset upper or lower bound. The numbers already selected remain
+    //! so, and are never selected again. Takes O(k) for k numbers
+    //! selected so far.
 	void reset_range(unsigned int new_u);
 	void reset_range(unsigned int new_u, unsigned int new_l);
 
 protected:
-    //! upper index if the list [_l,_u)
+    //! upper position of the free numbers [_l,_u)
     unsigned int _u;
 
-    //! lower index
+    //! lower position of the free numbers
     unsigned int _l;
 
-    //! a method that choses an int in [_l,_u)
+    //! a method that choses a position in [_l,_u)
     virtual unsigned int select() = 0;
 
 private:
-    //! Keep track of all encountered values (to return _l instead of it)
-    std::unordered_set<unsigned int> _picked;
+    //! lower bound of the range, as given by the user
+    unsigned int _lower;
 
-    //! an index is free if it has never been chosen before
-    //! that is if no links are going out of it
-    inline bool is_free(unsigned int idx) const;
+    //! positions of [_l,_u) not holding themselves, and what they hold
+    std::unordered_map<unsigned int, unsigned int> _moved;
+
+    //! all numbers selected so far, to rebuild the above on reset
+    std::unordered_set<unsigned int> _picked;
 
-    //! increase _l until it is located on a free index
-    inline void increase_l_till_free();
+    //! the number at position pos
+    inline unsigned int at(unsigned int pos) const;
 
-    //! modify all links coming into src_to so that they now go to dst_to
-    inline void modify_target(unsigned int src_to, unsigned int dst_to);
+    //! put val at position pos
+    inline void place(unsigned int pos, unsigned int val);
 };
 
 /** @}*/
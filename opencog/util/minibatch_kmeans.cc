@@ -0,0 +1,274 @@
+/*
+ * opencog/util/minibatch_kmeans.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "minibatch_kmeans.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "exceptions.h"
+#include "kmeans_seeding.h"
+#include "mt19937ar.h"
+#include "oc_assert.h"
+#include "simd_distance.h"
+
+using namespace opencog;
+
+#ifndef WIN32
+namespace {
+
+//! Unmaps a file mapping when leaving its scope, even by an exception.
+struct unmap_guard
+{
+    void* map;
+    size_t size;
+    ~unmap_guard() { munmap(map, size); }
+};
+
+} // ~namespace
+#endif
+
+minibatch_kmeans::minibatch_kmeans(int nclusters, int ncolumns,
+                                   size_t batch_size, unsigned seed)
+    : _k(nclusters), _m(ncolumns), _batch_size(batch_size), _seed(seed),
+      _rows_seen(0), _centers(size_t(nclusters) * ncolumns),
+      _counts(nclusters, 0)
+{
+    OC_ASSERT(nclusters > 0 and ncolumns > 0,
+              "minibatch_kmeans - needs clusters and columns");
+    OC_ASSERT(batch_size >= size_t(nclusters),
+              "minibatch_kmeans - batches must have at least nclusters rows");
+}
+
+minibatch_kmeans::minibatch_kmeans(const std::string& filename)
+{
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    if (not in)
+        throw IOException(TRACE_INFO,
+            "minibatch_kmeans - unable to open file \"%s\"",
+            filename.c_str());
+    fileHeader header;
+    if (not in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        or std::memcmp(header.magic, magic(), sizeof(header.magic)) != 0
+        or header.version != version
+        or header.nclusters <= 0 or header.ncolumns <= 0
+        or header.batch_size < uint64_t(header.nclusters))
+        throw IOException(TRACE_INFO,
+            "minibatch_kmeans - \"%s\" is not a saved minibatch_kmeans",
+            filename.c_str());
+    _k = header.nclusters;
+    _m = header.ncolumns;
+    _batch_size = header.batch_size;
+    _seed = header.seed;
+    _rows_seen = header.rows_seen;
+    _centers.resize(size_t(_k) * _m);
+    _counts.resize(_k);
+    in.read(reinterpret_cast<char*>(_centers.data()),
+            sizeof(double) * _centers.size());
+    in.read(reinterpret_cast<char*>(_counts.data()),
+            sizeof(uint64_t) * _counts.size());
+    if (not in or in.peek() != EOF)
+        throw IOException(TRACE_INFO,
+            "minibatch_kmeans - \"%s\" is not a saved minibatch_kmeans",
+            filename.c_str());
+}
+
+void minibatch_kmeans::save(const std::string& filename) const
+{
+    fileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic(), sizeof(header.magic));
+    header.version = version;
+    header.nclusters = _k;
+    header.ncolumns = _m;
+    header.seed = _seed;
+    header.batch_size = _batch_size;
+    header.rows_seen = _rows_seen;
+
+    // Write to a temporary file first, so that the last checkpoint is
+    // not lost if the process dies while writing the next one.
+    std::string tmp = filename + ".tmp";
+    std::ofstream out(tmp.c_str(), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(_centers.data()),
+              sizeof(double) * _centers.size());
+    out.write(reinterpret_cast<const char*>(_counts.data()),
+              sizeof(uint64_t) * _counts.size());
+    out.close();
+    if (not out or std::rename(tmp.c_str(), filename.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        throw IOException(TRACE_INFO,
+            "minibatch_kmeans - unable to write file \"%s\"",
+            filename.c_str());
+    }
+}
+
+void minibatch_kmeans::seed_centers(const double* rows, size_t nrows)
+{
+    OC_ASSERT(nrows >= size_t(_k),
+              "minibatch_kmeans - the first batch needs nclusters rows");
+    MT19937RandGen rng(_seed);
+    kmeans_pp_seeding(nrows, _k, rng,
+        [&](int j, size_t s) {
+            std::copy(rows + s * _m, rows + (s + 1) * _m,
+                      &_centers[size_t(j) * _m]);
+        },
+        [&](size_t i, int j) {
+            return l2_distance_sq(rows + i * _m, center(j), _m);
+        });
+}
+
+void minibatch_kmeans::partial_fit(const double* rows, size_t nrows)
+{
+    if (nrows == 0) return;
+    if (_rows_seen == 0) seed_centers(rows, nrows);
+
+    // Centers of the rows, before moving any
+    _nearest.resize(nrows);
+    #pragma omp parallel for
+    for (size_t i = 0; i < nrows; i++)
+        _nearest[i] = predict(rows + i * _m);
+
+    for (size_t i = 0; i < nrows; i++) {
+        int j = _nearest[i];
+        double eta = 1.0 / ++_counts[j];
+        double* c = &_centers[size_t(j) * _m];
+        const double* x = rows + i * _m;
+        for (int l = 0; l < _m; l++) c[l] += eta * (x[l] - c[l]);
+    }
+    _rows_seen += nrows;
+}
+
+void minibatch_kmeans::fit_file(const std::string& filename, unsigned epochs,
+                                const std::string& checkpoint,
+                                size_t checkpoint_every)
+{
+    const size_t row_size = sizeof(double) * _m;
+    uint64_t size = 0;
+#ifndef WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 or fstat(fd, &st) != 0) {
+        if (fd >= 0) close(fd);
+        throw IOException(TRACE_INFO,
+            "minibatch_kmeans - unable to open file \"%s\"",
+            filename.c_str());
+    }
+    size = st.st_size;
+#else
+    std::ifstream in(filename.c_str(), std::ios::binary | std::ios::ate);
+    if (not in)
+        throw IOException(TRACE_INFO,
+            "minibatch_kmeans - unable to open file \"%s\"",
+            filename.c_str());
+    size = in.tellg();
+#endif
+    const uint64_t nrows = size / row_size;
+    if (nrows == 0 or size % row_size != 0) {
+#ifndef WIN32
+        close(fd);
+#endif
+        throw IOException(TRACE_INFO,
+            "minibatch_kmeans - \"%s\" is not a matrix of %d columns",
+            filename.c_str(), _m);
+    }
+
+#ifndef WIN32
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        throw IOException(TRACE_INFO,
+            "minibatch_kmeans - unable to map file \"%s\"",
+            filename.c_str());
+    unmap_guard unmap{map, size};
+    madvise(map, size, MADV_SEQUENTIAL);
+    const char* data = static_cast<const char*>(map);
+    const size_t page = sysconf(_SC_PAGESIZE);
+#endif
+
+    size_t batches = 0;
+    while (_rows_seen < epochs * nrows) {
+        uint64_t first = _rows_seen % nrows;
+        uint64_t n = std::min<uint64_t>({_batch_size, nrows - first,
+                                         epochs * nrows - _rows_seen});
+#ifndef WIN32
+        partial_fit(reinterpret_cast<const double*>(data + first * row_size),
+                    n);
+        // Release the pages of the batch, but the one it shares with
+        // the next.
+        size_t begin = first * row_size / page * page;
+        size_t end = (first + n) * row_size / page * page;
+        if (end > begin)
+            madvise(const_cast<char*>(data) + begin, end - begin,
+                    MADV_DONTNEED);
+#else
+        _batch.resize(n * _m);
+        in.seekg(first * row_size);
+        if (not in.read(reinterpret_cast<char*>(_batch.data()),
+                        n * row_size))
+            throw IOException(TRACE_INFO,
+                "minibatch_kmeans - unable to read file \"%s\"",
+                filename.c_str());
+        partial_fit(_batch.data(), n);
+#endif
+        if (not checkpoint.empty() and checkpoint_every > 0
+            and ++batches % checkpoint_every == 0) {
+            save(checkpoint);
+        }
+    }
+    if (not checkpoint.empty()) save(checkpoint);
+}
+
+int minibatch_kmeans::predict(const double* row) const
+{
+    int best = 0;
+    double least = DBL_MAX;
+    for (int j = 0; j < _k; j++) {
+        double d = l2_distance_sq(row, center(j), _m);
+        if (d < least) {
+            least = d;
+            best = j;
+        }
+    }
+    return best;
+}
+
+double minibatch_kmeans::error(const double* rows, size_t nrows) const
+{
+    double total = 0;
+    #pragma omp parallel for reduction(+:total)
+    for (size_t i = 0; i < nrows; i++) {
+        const double* x = rows + i * _m;
+        total += l2_distance_sq(x, center(predict(x)), _m);
+    }
+    return total;
+}
@@ -0,0 +1,176 @@
+/*
+ * opencog/util/minibatch_kmeans.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_MINIBATCH_KMEANS_H
+#define _OPENCOG_MINIBATCH_KMEANS_H
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace opencog
+{
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+/**
+ * Mini-batch k-means (Sculley, "Web-scale k-means clustering", 2010),
+ * to cluster more rows than fit in memory.
+ *
+ * The rows, of ncolumns values each, are fed by batches, from arrays,
+ * from iterators, or from a file mapped in memory. Each row of a
+ * batch is assigned to its nearest center, and then moves it by
+ * 1/(number of rows assigned to it so far), so that each center stays
+ * the mean of the rows it was given. Only the centers and one batch
+ * are kept in memory. The first batch seeds the centers by k-means++.
+ * The distance is euclidean, as for kcluster with dist=='e' and equal
+ * weights.
+ *
+ * Rows are taken in the order they come: if they are sorted in any
+ * way, they should be shuffled first.
+ *
+ * The state can be saved at any time, and loaded to go on with more
+ * batches; fit_file() resumes where the saved model stopped.
+ */
+class minibatch_kmeans
+{
+public:
+    minibatch_kmeans(int nclusters, int ncolumns, size_t batch_size = 1024,
+                     unsigned seed = 0);
+
+    /**
+     * Load the model saved to filename. Throws an IOException if it
+     * cannot be read, or was not saved by a minibatch_kmeans.
+     */
+    explicit minibatch_kmeans(const std::string& filename);
+
+    /**
+     * Write the model to filename, replacing it only once written.
+     * Throws an IOException on failure.
+     */
+    void save(const std::string& filename) const;
+
+    /**
+     * Update the centers with a batch of nrows rows, stored one after
+     * the other. The first batch must have at least nclusters rows.
+     */
+    void partial_fit(const double* rows, size_t nrows);
+
+    /**
+     * Update the centers with the rows in [first, last), each a range
+     * of ncolumns values, by batches of batch_size() rows.
+     */
+    template<typename It>
+    void fit(It first, It last);
+
+    /**
+     * Update the centers with the rows of filename, a matrix of
+     * doubles stored row after row, without header, by batches of
+     * batch_size() rows, until epochs times its rows have been seen.
+     *
+     * The file is mapped in memory, and the pages of each batch are
+     * released once it is done, so that files larger than memory can
+     * be used. It starts from row rows_seen() modulo the number of
+     * rows, so a model saved during a fit_file, and loaded, resumes
+     * where it stopped, as long as it was only fed by that file. If
+     * checkpoint is not empty, the model is saved to it every
+     * checkpoint_every batches, if not 0, and at the end. Batches do
+     * not cross the end of the file. Throws an IOException if the
+     * file cannot be read.
+     */
+    void fit_file(const std::string& filename, unsigned epochs = 1,
+                  const std::string& checkpoint = "",
+                  size_t checkpoint_every = 0);
+
+    //! Index of the center nearest to row.
+    int predict(const double* row) const;
+
+    //! Sum of the squared distances of nrows rows to their nearest
+    //! center.
+    double error(const double* rows, size_t nrows) const;
+
+    int nclusters() const { return _k; }
+    int ncolumns() const { return _m; }
+    size_t batch_size() const { return _batch_size; }
+
+    //! Number of rows given so far; the centers are seeded after the
+    //! first batch.
+    uint64_t rows_seen() const { return _rows_seen; }
+
+    //! The centers, one after the other.
+    const std::vector<double>& centers() const { return _centers; }
+    const double* center(int j) const { return &_centers[size_t(j) * _m]; }
+
+    //! Number of rows assigned to each center.
+    const std::vector<uint64_t>& counts() const { return _counts; }
+
+private:
+    struct fileHeader {
+        char magic[8];
+        uint32_t version;
+        int32_t nclusters;
+        int32_t ncolumns;
+        uint32_t seed;
+        uint64_t batch_size;
+        uint64_t rows_seen;
+    };
+
+    static const char* magic() { return "OCMBKM1"; }
+    static const uint32_t version = 1;
+
+    void seed_centers(const double* rows, size_t nrows);
+
+    int _k, _m;
+    size_t _batch_size;
+    unsigned _seed;
+    uint64_t _rows_seen;
+    std::vector<double> _centers;
+    std::vector<uint64_t> _counts;
+
+    //rows buffered by fit, and the centers of the rows of a batch
+    std::vector<double> _batch;
+    std::vector<int> _nearest;
+};
+
+template<typename It>
+void minibatch_kmeans::fit(It first, It last)
+{
+    _batch.clear();
+    size_t n = 0;
+    for (; first != last; ++first) {
+        auto value = std::begin(*first);
+        for (int j = 0; j < _m; j++, ++value) _batch.push_back(*value);
+        if (++n == _batch_size) {
+            partial_fit(_batch.data(), n);
+            _batch.clear();
+            n = 0;
+        }
+    }
+    if (n > 0) partial_fit(_batch.data(), n);
+}
+
+/** @}*/
+} // ~namespace opencog
+
+#endif // _OPENCOG_MINIBATCH_KMEANS_H
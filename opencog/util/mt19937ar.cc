@@ -23,6 +23,8 @@
 
 #include "mt19937ar.h"
 
+#include <numeric>
+
 #include <opencog/util/numeric.h>
 
 //#define  DEBUG_RAND_CALLS
@@ -66,8 +68,10 @@ double MT19937RandGen::randdouble_one_excluded() {
 int MT19937RandGen::randint(int n) {
     if ( 0 == n)
         return n;
-    else
+    else if (n < 0 or _legacy_randint)
         return (int)randint() % n;
+    else
+        return randbounded32(n);
 }
 
 // return -1 or 1 randonly
@@ -77,14 +81,32 @@ int MT19937RandGen::rand_positive_negative(){
 
 //random boolean
 bool MT19937RandGen::randbool() {
-    return randint() % 2 == 0;
+    if (_legacy_randint)
+        return randint() % 2 == 0;
+    return operator()() >> 31;
 }
 
 // random integer values according to a discrete distribution
+//
+// This draws exactly what std::discrete_distribution would (same
+// random number, same normalized cumulative probabilities, same
+// lower bound), so existing runs are reproduced, but without
+// allocating the distribution's tables for a single draw. For many
+// draws over the same weights, see alias_sampler.
 int MT19937RandGen::rand_discrete(const std::vector<double>& weights)
 {
-    std::discrete_distribution<int> distribution(weights.begin(), weights.end());
-    return distribution(*this);
+    if (weights.size() <= 1)
+        return 0;
+    double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double p = randdouble_one_excluded();
+    double cp = 0;
+    int last = weights.size() - 1;
+    for (int i = 0; i < last; i++) {
+        cp += weights[i] / sum;
+        if (p <= cp)
+            return i;
+    }
+    return last;
 }
 
 RandGen& opencog::randGen()
@@ -61,6 +61,7 @@ public:
 
     //! random discrete distribution according to some weights
     int rand_discrete(const std::vector<double>&);
+    using RandGen::rand_discrete;
 };
 
 /**
@@ -31,11 +31,13 @@
 #include <numeric>
 #include <vector>
 #include <functional>
+#include <type_traits>
 
 #include <boost/range/numeric.hpp>
 
 #include <opencog/util/iostreamContainer.h>
 #include <opencog/util/oc_assert.h>
+#include <opencog/util/simd_distance.h>
 
 /** \addtogroup grp_cogutil
  *  @{
@@ -94,7 +96,7 @@ inline unsigned int integer_log2(size_t v)
 template<typename T>
 T next_power_of_two(T x)
 {
-    cassert(x > 0, "next_power_of_two - x must be > 0");
+    OC_ASSERT(x > 0, "next_power_of_two - x must be > 0");
     --x;
     x |= x >> 1;
     x |= x >> 2;
@@ -282,10 +284,31 @@ Float generalized_mean(const C& c, Float p = 1.0)
     return generalized_mean(c.begin(), c.end(), p);
 }
 
+namespace detail {
+
+//! Vectors for which the kernels of simd_distance.h are used.
+template<typename Vec> struct has_distance_kernel : std::false_type {};
+template<> struct has_distance_kernel<std::vector<float>> : std::true_type {};
+template<> struct has_distance_kernel<std::vector<double>> : std::true_type {};
+
+//! Whether to use the kernels for a distance asked in Float. They sum
+//! in the precision of the elements, so not for floats asked in double.
+template<typename Vec, typename Float>
+struct use_distance_kernel
+    : std::integral_constant<bool, has_distance_kernel<Vec>::value and
+          std::numeric_limits<typename Vec::value_type>::digits >=
+          std::numeric_limits<Float>::digits> {};
+
+} // ~namespace detail
+
 /// Compute the distance between two vectors, using the p-norm.  For
 /// p=2, this is the usual Eucliden distance, and for p=1, this is the
 /// Manhattan distance, and for p=0 or negative, this is the maximum
 /// difference for one element.
+///
+/// For std::vector<float> and std::vector<double>, the three special
+/// cases are computed by the SIMD kernels of simd_distance.h, unless
+/// Float is more precise than the elements.
 template<typename Vec, typename Float>
 Float p_norm_distance(const Vec& a, const Vec& b, Float p=1.0)
 {
@@ -293,6 +316,15 @@ Float p_norm_distance(const Vec& a, const Vec& b, Float p=1.0)
                "Cannot compare unequal-sized vectors!  %d %d\n",
                a.size(), b.size());
 
+    if constexpr (detail::use_distance_kernel<Vec, Float>::value) {
+        if (1.0 == p)
+            return l1_distance(a.data(), b.data(), a.size());
+        if (2.0 == p)
+            return sqrt(l2_distance_sq(a.data(), b.data(), a.size()));
+        if (0.0 >= p)
+            return linf_distance(a.data(), b.data(), a.size());
+    }
+
     typename Vec::const_iterator ia = a.begin(), ib = b.begin();
 
     Float sum = 0.0;
@@ -360,10 +392,17 @@ Float tanimoto_distance(const Vec& a, const Vec& b)
                "Cannot compare unequal-sized vectors!  %d %d\n",
                a.size(), b.size());
 
-    Float ab = boost::inner_product(a, b, Float(0)),
-        aa = boost::inner_product(a, a, Float(0)),
-        bb = boost::inner_product(b, b, Float(0)),
-        numerator = aa + bb - ab;
+    Float ab, aa, bb;
+    if constexpr (detail::use_distance_kernel<Vec, Float>::value) {
+        typename Vec::value_type xab, xaa, xbb;
+        dot_products(a.data(), b.data(), a.size(), xab, xaa, xbb);
+        ab = xab; aa = xaa; bb = xbb;
+    } else {
+        ab = boost::inner_product(a, b, Float(0));
+        aa = boost::inner_product(a, a, Float(0));
+        bb = boost::inner_product(b, b, Float(0));
+    }
+    Float numerator = aa + bb - ab;
 
     if (numerator >= Float(DISTANCE_EPSILON))
         return 1 - (ab / numerator);
@@ -396,15 +435,19 @@ Float angular_distance(const Vec& a, const Vec& b, bool pos_n_neg = true)
                "Cannot compare unequal-sized vectors!  %d %d\n",
                a.size(), b.size());
 
-    // XXX FIXME writing out the explicit loop will almost
-    // surely be faster than calling boost. Why? Because a single
-    // loop allows the compiler to insert instructions into the
-    // pipeline bubbles; whereas three different loops will be more
-    // than three times slower!
-    Float ab = boost::inner_product(a, b, Float(0)),
-        aa = boost::inner_product(a, a, Float(0)),
-        bb = boost::inner_product(b, b, Float(0)),
-        numerator = sqrt(aa * bb);
+    // Contiguous floats or doubles get the three sums in a single,
+    // vectorized loop.
+    Float ab, aa, bb;
+    if constexpr (detail::use_distance_kernel<Vec, Float>::value) {
+        typename Vec::value_type xab, xaa, xbb;
+        dot_products(a.data(), b.data(), a.size(), xab, xaa, xbb);
+        ab = xab; aa = xaa; bb = xbb;
+    } else {
+        ab = boost::inner_product(a, b, Float(0));
+        aa = boost::inner_product(a, a, Float(0));
+        bb = boost::inner_product(b, b, Float(0));
+    }
+    Float numerator = sqrt(aa * bb);
 
     if (numerator >= Float(DISTANCE_EPSILON)) {
         // in case of rounding error
@@ -417,7 +460,7 @@ Float angular_distance(const Vec& a, const Vec& b, bool pos_n_neg = true)
 
 template<typename FloatT> FloatT round(FloatT x)
 {
-    cassert(std::isfinite(x), "round - x must be finite");
+    OC_ASSERT(std::isfinite(x), "round - x must be finite");
     return x < 0.0 ? std::ceil(x - 0.5) : std::floor(x + 0.5);
 }
 
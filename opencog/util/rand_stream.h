@@ -0,0 +1,118 @@
+/*
+ * opencog/util/rand_stream.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_RAND_STREAM_H
+#define _OPENCOG_RAND_STREAM_H
+
+#include <cstdint>
+#include <random>
+
+#include <opencog/util/fast_rng.h>
+#include <opencog/util/mt19937ar.h>
+
+/**
+ * \file rand_stream.h
+ *
+ * Reproducible random streams for parallel work.
+ *
+ * randGen() is seeded with 0 in every thread, so all threads draw the
+ * same numbers, and what a task draws depends on which thread runs
+ * it, and after which other tasks. The functions below instead give
+ * each task its own stream, a pure function of a global seed and of
+ * the task id: the results of a parallel run then no longer depend on
+ * the scheduling, the number of threads, or even the number of
+ * processes, and no generator state is shared between threads.
+ *
+ * For instance:
+ * \code
+ * OMP_ALGO::for_each(tasks.begin(), tasks.end(), [&](task& t) {
+ *     rand_stream_scope scope(seed, t.id);
+ *     t.run();   // Uses randGen() as usual
+ * });
+ * \endcode
+ */
+
+namespace opencog
+{
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+//! Counter-based generator of the stream of a task.
+/**
+ * Philox keyed with the seed, with the task id in the high half of
+ * its counter: streams of distinct tasks never overlap, and creating
+ * one costs next to nothing.
+ */
+inline FastRandGen<philox4x32> task_rng(uint64_t seed, uint64_t task)
+{
+    FastRandGen<philox4x32> rng;
+    rng.engine().seed(seed, task);
+    return rng;
+}
+
+//! Seed rng with the stream of a task.
+/**
+ * The Mersenne Twister state is filled through std::seed_seq from
+ * both the seed and the task id. Unlike task_rng(), this does not
+ * guarantee that streams never overlap, though with a period of
+ * 2^19937 - 1 an overlap is not a practical concern.
+ */
+inline void seed_task(RandGen& rng, uint64_t seed, uint64_t task)
+{
+    std::seed_seq seq{uint32_t(seed), uint32_t(seed >> 32),
+                      uint32_t(task), uint32_t(task >> 32)};
+    rng.seed(seq);
+}
+
+//! Make randGen() (or rng) draw from the stream of a task, until the
+//! end of the scope.
+/**
+ * On exit, the generator is put back in the state it was in, so
+ * that code running around the task is unaffected.
+ */
+class rand_stream_scope
+{
+public:
+    rand_stream_scope(uint64_t seed, uint64_t task, RandGen& rng = randGen())
+        : _rng(rng), _saved(rng)
+    {
+        seed_task(_rng, seed, task);
+    }
+
+    ~rand_stream_scope()
+    {
+        static_cast<std::mt19937&>(_rng) = _saved;
+    }
+
+    rand_stream_scope(const rand_stream_scope&) = delete;
+    rand_stream_scope& operator=(const rand_stream_scope&) = delete;
+
+private:
+    RandGen& _rng;
+    std::mt19937 _saved;
+};
+
+/** @}*/
+} // ~namespace opencog
+
+#endif // _OPENCOG_RAND_STREAM_H
@@ -24,11 +24,17 @@
 #ifndef _OPENCOG_RANDOM_H
 #define _OPENCOG_RANDOM_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iomanip>
+#include <vector>
 
+#include <boost/dynamic_bitset.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 
 #include <opencog/util/dorepeat.h>
+#include <opencog/util/fast_rng.h>
 #include <opencog/util/RandGen.h>
 #include <opencog/util/mt19937ar.h>
 #include <opencog/util/numeric.h>
@@ -122,6 +128,161 @@ static inline bool biased_randbool(float b, RandGen& rng=randGen())
     return b > rng.randfloat();
 }
 
+/**
+ * Bulk generation.
+ *
+ * The fill_* functions below write a whole array of random values at
+ * once. Raw words are drawn from an xoshiro256pp_x4 a block at a
+ * time, then turned into values in a separate, branch-free loop, so
+ * both steps vectorize (with AVX2 if the build enables it). For
+ * batches, this costs a fraction of one RandGen call per value.
+ */
+namespace detail {
+
+//! Number of raw words drawn per block by the fill_* functions.
+static const size_t fill_block = 256;
+
+//! Doubles in [0,1) from the top 52 bits of each word.
+inline void words_to_unit(const uint64_t* w, double* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        uint64_t bits = (w[i] >> 12) | 0x3ff0000000000000ULL;
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+        out[i] = d - 1.0;
+    }
+}
+
+} // ~namespace detail
+
+//! Fill out[0..n) with doubles uniformly drawn in [0,1).
+inline void fill_uniform(double* out, size_t n,
+                         xoshiro256pp_x4& rng=bulkRandGen())
+{
+    uint64_t w[detail::fill_block];
+    for (size_t i = 0; i < n; i += detail::fill_block) {
+        size_t k = std::min(detail::fill_block, n - i);
+        rng.generate(w, k);
+        detail::words_to_unit(w, out + i, k);
+    }
+}
+
+//! Fill out[0..n) with floats uniformly drawn in [0,1).
+inline void fill_uniform(float* out, size_t n,
+                         xoshiro256pp_x4& rng=bulkRandGen())
+{
+    // Two floats, of 23 random bits each, per word.
+    uint64_t w[detail::fill_block];
+    for (size_t i = 0; i < n; i += 2 * detail::fill_block) {
+        size_t k = std::min(2 * detail::fill_block, n - i);
+        rng.generate(w, (k + 1) / 2);
+        for (size_t j = 0; j < k; j++) {
+            uint32_t half = uint32_t(w[j / 2] >> (32 * (j & 1)));
+            uint32_t bits = (half >> 9) | 0x3f800000u;
+            float f;
+            std::memcpy(&f, &bits, sizeof(f));
+            out[i + j] = f - 1.0f;
+        }
+    }
+}
+
+//! Fill out[0..n) with ints uniformly drawn in [0,bound).
+/**
+ * Uses Lemire's multiply-and-shift, with the rare rejected draws
+ * redone afterwards, so the result is unbiased.
+ */
+inline void fill_randint(int* out, size_t n, int bound,
+                         xoshiro256pp_x4& rng=bulkRandGen())
+{
+    OC_ASSERT(bound > 0, "fill_randint - bound must be > 0");
+    const uint32_t range = bound;
+    const uint32_t threshold = uint32_t(-range) % range;
+    uint64_t w[detail::fill_block];
+    for (size_t i = 0; i < n; i += 2 * detail::fill_block) {
+        size_t k = std::min(2 * detail::fill_block, n - i);
+        rng.generate(w, (k + 1) / 2);
+        bool reject = false;
+        for (size_t j = 0; j < k; j++) {
+            uint64_t m = (w[j / 2] >> (32 * (j & 1)) & 0xffffffffULL) * range;
+            out[i + j] = int(m >> 32);
+            reject |= uint32_t(m) < threshold;
+        }
+        if (not reject) continue;
+        for (size_t j = 0; j < k; j++) {
+            uint64_t m = (w[j / 2] >> (32 * (j & 1)) & 0xffffffffULL) * range;
+            while (uint32_t(m) < threshold)
+                m = uint64_t(uint32_t(rng() >> 32)) * range;
+            out[i + j] = int(m >> 32);
+        }
+    }
+}
+
+//! Fill out[0..n) with samples of a Gaussian distribution.
+/**
+ * Box-Muller, keeping both outputs of each transform, so a pair of
+ * samples costs one log, one sqrt, one sin and one cos.
+ */
+inline void fill_gaussian(double* out, size_t n, double mean, double std_dev,
+                          xoshiro256pp_x4& rng=bulkRandGen())
+{
+    const size_t half = detail::fill_block / 2;
+    double u[detail::fill_block];
+    for (size_t i = 0; i < n; i += 2 * half) {
+        size_t k = std::min(2 * half, n - i);
+        size_t pairs = (k + 1) / 2;
+        fill_uniform(u, 2 * pairs, rng);
+        for (size_t j = 0; j < pairs; j++) {
+            // 1 - u is in (0,1], so the log is finite.
+            double r = std_dev * std::sqrt(-2.0 * std::log(1.0 - u[j]));
+            double theta = 2.0 * M_PI * u[pairs + j];
+            u[j] = mean + r * std::cos(theta);
+            u[pairs + j] = mean + r * std::sin(theta);
+        }
+        std::copy(u, u + std::min(pairs, k), out + i);
+        std::copy(u + pairs, u + pairs + (k - pairs), out + i + pairs);
+    }
+}
+
+//! Resize bits to n and set each bit independently with probability p.
+/**
+ * Builds whole 64-bit words at a time from the binary expansion of p
+ * (to 32 bits of precision): for p = 0.5 that takes a single random
+ * word per 64 bits, and never more than 32.
+ */
+inline void fill_bool(boost::dynamic_bitset<>& bits, size_t n, double p,
+                      xoshiro256pp_x4& rng=bulkRandGen())
+{
+    OC_ASSERT(p >= 0 and p <= 1, "fill_bool - p must be in [0,1]");
+    typedef boost::dynamic_bitset<>::block_type block_type;
+    static_assert(sizeof(block_type) == sizeof(uint64_t),
+                  "fill_bool - 64 bit blocks expected");
+
+    // p as a 32-bit fixed point fraction, trailing zeros dropped.
+    uint64_t q = uint64_t(p * 4294967296.0 + 0.5);
+    int nbits = 32;
+    bool all = q >> 32;
+    while (nbits > 0 and q and 0 == (q & 1)) { q >>= 1; nbits--; }
+
+    std::vector<block_type> blocks((n + 63) / 64);
+    if (all)
+        std::fill(blocks.begin(), blocks.end(), ~block_type(0));
+    else if (q) {
+        // Reading the bits of q from the lowest, a 1 ORs in a fresh
+        // random word and a 0 ANDs one in: each step halves the
+        // probability and adds that bit, so the result is q/2^nbits.
+        std::vector<uint64_t> w(blocks.size());
+        for (int b = 0; b < nbits; b++) {
+            rng.generate(w.data(), w.size());
+            bool one = (q >> b) & 1;
+            for (size_t i = 0; i < blocks.size(); i++)
+                blocks[i] = one ? (blocks[i] | w[i]) : (blocks[i] & w[i]);
+        }
+    }
+    bits.clear();
+    bits.append(blocks.begin(), blocks.end());
+    bits.resize(n);
+}
+
 //! Generate a random string of characters in the given base, using n
 //! random ints, and appending it to a given prefix.
 static inline std::string randstr(const std::string& prefix=std::string(),
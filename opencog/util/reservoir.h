@@ -0,0 +1,353 @@
+/*
+ * opencog/util/reservoir.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_RESERVOIR_H
+#define _OPENCOG_RESERVOIR_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <opencog/util/oc_assert.h>
+#include <opencog/util/RandGen.h>
+#include <opencog/util/mt19937ar.h>
+
+/**
+ * \file reservoir.h
+ *
+ * Sampling from streams too large to hold in memory.
+ *
+ * The samplers below see the items of a stream one at a time and
+ * keep a sample of k of them, in O(k) memory. They work with any
+ * generator providing randint(n) and randdouble_one_excluded(), such
+ * as RandGen or FastRandGen; rand_subset() needs randbounded64(n)
+ * instead. Samplers filled in different threads
+ * (with different generators, see rand_stream.h) can be merged into
+ * a sample of the whole stream.
+ */
+
+namespace opencog
+{
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+namespace detail {
+
+//! Uniform double in (0,1].
+template<typename Rng>
+double rand_open_zero(Rng& rng)
+{
+    return 1.0 - rng.randdouble_one_excluded();
+}
+
+} // ~namespace detail
+
+//! Uniform sampling of k items of a stream, without replacement.
+/**
+ * Li's Algorithm L: once the reservoir is full, the number of items
+ * to skip before the next one enters it is drawn directly, so a
+ * stream of n items takes O(k (1 + log(n/k))) random draws rather
+ * than n. Callers that can skip items cheaply can ask for to_skip().
+ */
+template<typename T, typename Rng = RandGen>
+class reservoir_sampler
+{
+public:
+    reservoir_sampler(size_t k, Rng& rng = randGen())
+        : _k(k), _seen(0), _next(0), _log_w(0), _rng(rng)
+    {
+        OC_ASSERT(0 < k and k <= size_t(std::numeric_limits<int>::max()),
+                  "reservoir_sampler - k out of range");
+        _sample.reserve(k);
+    }
+
+    //! Show the next item of the stream.
+    void add(const T& x)
+    {
+        if (_seen < _k) {
+            _sample.push_back(x);
+            if (++_seen == _k) {
+                _log_w = std::log(detail::rand_open_zero(_rng)) / _k;
+                draw_next_();
+            }
+            return;
+        }
+        if (_seen++ == _next) {
+            _sample[_rng.randint(int(_k))] = x;
+            _log_w += std::log(detail::rand_open_zero(_rng)) / _k;
+            draw_next_();
+        }
+    }
+
+    //! Show all items of [from, to), jumping over the skipped ones.
+    template<typename It>
+    void add(It from, It to)
+    {
+        while (from != to) {
+            uint64_t skip = to_skip();
+            if (skip > 0) {
+                auto left = std::distance(from, to);
+                if (uint64_t(left) <= skip) {
+                    _seen += left;
+                    return;
+                }
+                std::advance(from, skip);
+                _seen += skip;
+            }
+            add(*from++);
+        }
+    }
+
+    //! Number of upcoming items that will not enter the reservoir,
+    //! which the caller may pass over (then call skip()).
+    uint64_t to_skip() const
+    {
+        return _seen < _k ? 0 : _next - _seen;
+    }
+
+    //! Pass over n items, at most to_skip().
+    void skip(uint64_t n)
+    {
+        OC_ASSERT(n <= to_skip(), "reservoir_sampler - skipping too far");
+        _seen += n;
+    }
+
+    /**
+     * Merge the sample of another part of the stream, so that this
+     * holds a uniform sample of both parts. The number of items taken
+     * from each is drawn from the hypergeometric distribution, then
+     * that many are taken uniformly from each sample.
+     */
+    void merge(const reservoir_sampler& other)
+    {
+        OC_ASSERT(_k == other._k, "reservoir_sampler - k differ");
+        std::vector<T> a(std::move(_sample)), b(other._sample);
+        uint64_t na = _seen, nb = other._seen;
+        _seen = na + nb;
+        _sample.clear();
+        while (_sample.size() < _k and (na + nb) > 0) {
+            bool from_a = _rng.randdouble_one_excluded() * (na + nb) < na;
+            std::vector<T>& v = from_a ? a : b;
+            (from_a ? na : nb)--;
+            size_t i = _rng.randint(int(v.size()));
+            _sample.push_back(std::move(v[i]));
+            v[i] = std::move(v.back());
+            v.pop_back();
+        }
+        if (_seen >= _k) {
+            // The largest of the k smallest of n uniform keys is
+            // Beta(k, n - k + 1) distributed.
+            std::gamma_distribution<double> ga(_k), gb(_seen - _k + 1);
+            double x = ga(_rng), y = gb(_rng);
+            _log_w = std::log(x / (x + y));
+            draw_next_();
+        }
+    }
+
+    //! The sample so far, of min(k, seen()) items, in no particular
+    //! order.
+    const std::vector<T>& sample() const { return _sample; }
+
+    //! Number of items shown so far.
+    uint64_t seen() const { return _seen; }
+
+    size_t capacity() const { return _k; }
+
+private:
+    size_t _k;
+    uint64_t _seen;
+
+    //! Index of the next item to enter the reservoir.
+    uint64_t _next;
+
+    //! log of W, the largest key of the reservoir.
+    double _log_w;
+
+    std::vector<T> _sample;
+    Rng& _rng;
+
+    void draw_next_()
+    {
+        // Geometric number of items to skip, of parameter W.
+        double skip = std::floor(std::log(detail::rand_open_zero(_rng))
+                                 / std::log1p(-std::exp(_log_w)));
+        const double max_skip = 1e18;
+        _next = _seen + uint64_t(std::isnan(skip) ? 0 :
+                                 std::min(skip, max_skip));
+    }
+};
+
+//! Weighted sampling of k items of a stream, without replacement.
+/**
+ * Efraimidis and Spirakis' A-ExpJ: each item gets the key u^(1/w),
+ * for u uniform in (0,1) and w its weight, and the k items of
+ * largest keys are kept. Once the reservoir is full, the total weight
+ * to skip before the next item enters it is drawn directly, so that
+ * most items cost an addition. Keys are kept as logarithms, so that
+ * tiny weights do not underflow.
+ */
+template<typename T, typename Rng = RandGen>
+class weighted_reservoir_sampler
+{
+    typedef std::pair<double, T> keyed;  // (log key, item)
+
+public:
+    weighted_reservoir_sampler(size_t k, Rng& rng = randGen())
+        : _k(k), _seen(0), _skipped(0), _jump(0), _rng(rng)
+    {
+        OC_ASSERT(k > 0, "weighted_reservoir_sampler - k must be > 0");
+        _heap.reserve(k);
+    }
+
+    //! Show the next item of the stream, with weight w >= 0. Items of
+    //! weight zero are never sampled.
+    void add(const T& x, double w)
+    {
+        OC_ASSERT(w >= 0, "weighted_reservoir_sampler - negative weight");
+        _seen++;
+        if (w == 0) return;
+        if (_heap.size() < _k) {
+            push_({std::log(detail::rand_open_zero(_rng)) / w, x});
+            if (_heap.size() == _k) draw_jump_();
+            return;
+        }
+        _skipped += w;
+        if (_skipped < _jump) return;
+
+        // The new key is drawn in (T_w^w, 1), T_w the smallest key.
+        double t = std::exp(w * min_key());
+        double u = t + (1 - t) * _rng.randdouble_one_excluded();
+        pop_();
+        push_({std::log(u) / w, x});
+        draw_jump_();
+    }
+
+    /**
+     * Merge the sample of another part of the stream. Keys being
+     * independent across items, the k largest keys of both samples
+     * are the k largest of the whole stream, so the merge is exact.
+     */
+    void merge(const weighted_reservoir_sampler& other)
+    {
+        OC_ASSERT(_k == other._k, "weighted_reservoir_sampler - k differ");
+        _seen += other._seen;
+        for (const keyed& kx : other._heap) {
+            if (_heap.size() < _k)
+                push_(kx);
+            else if (min_key() < kx.first) {
+                pop_();
+                push_(kx);
+            }
+        }
+        if (_heap.size() == _k) draw_jump_();
+    }
+
+    //! The sample so far, in no particular order.
+    std::vector<T> sample() const
+    {
+        std::vector<T> res;
+        res.reserve(_heap.size());
+        for (const keyed& kx : _heap) res.push_back(kx.second);
+        return res;
+    }
+
+    //! Number of items shown so far.
+    uint64_t seen() const { return _seen; }
+
+    size_t capacity() const { return _k; }
+
+private:
+    size_t _k;
+    uint64_t _seen;
+
+    //! Weight passed over since the last item entered the reservoir,
+    //! and how much has to be passed over for the next one to enter.
+    double _skipped, _jump;
+
+    //! Min-heap of the keyed items, on keys.
+    std::vector<keyed> _heap;
+    Rng& _rng;
+
+    static bool greater_key(const keyed& l, const keyed& r)
+    {
+        return l.first > r.first;
+    }
+
+    double min_key() const { return _heap.front().first; }
+
+    void push_(const keyed& kx)
+    {
+        _heap.push_back(kx);
+        std::push_heap(_heap.begin(), _heap.end(), greater_key);
+    }
+
+    void pop_()
+    {
+        std::pop_heap(_heap.begin(), _heap.end(), greater_key);
+        _heap.pop_back();
+    }
+
+    void draw_jump_()
+    {
+        // X_w = log(r) / log(T_w); no item can beat a key of 1.
+        double lt = min_key();
+        _skipped = 0;
+        _jump = lt < 0 ?
+            std::log(detail::rand_open_zero(_rng)) / lt :
+            std::numeric_limits<double>::infinity();
+    }
+};
+
+//! Return k distinct indices in [0,n), uniformly drawn and sorted.
+/**
+ * Floyd's algorithm: O(k) time and memory, whatever n is.
+ */
+template<typename Rng = RandGen>
+std::vector<uint64_t> rand_subset(uint64_t k, uint64_t n,
+                                  Rng& rng = randGen())
+{
+    OC_ASSERT(k <= n, "rand_subset - cannot draw more than n indices");
+    std::unordered_set<uint64_t> picked;
+    picked.reserve(k);
+    std::vector<uint64_t> res;
+    res.reserve(k);
+    for (uint64_t j = n - k; j < n; j++) {
+        uint64_t t = rng.randbounded64(j + 1);
+        res.push_back(picked.insert(t).second ? t : j);
+        if (res.back() == j) picked.insert(j);
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+/** @}*/
+} // ~namespace opencog
+
+#endif // _OPENCOG_RESERVOIR_H
@@ -26,7 +26,11 @@
 #include <opencog/util/functional.h>
 #include <opencog/util/numeric.h>
 #include <iterator>
+#include <vector>
+#include <opencog/util/discrete_sampler.h>
 #include <opencog/util/dorepeat.h>
+#include <opencog/util/rand_stream.h>
+#include <opencog/util/random.h>
 #include <opencog/util/RandGen.h>
 #include <opencog/util/mt19937ar.h>
 
@@ -72,6 +76,74 @@ struct tournament_selection
             *dst++ = *res;
         }
     }
+
+    /**
+     * Batched version of the above, for large populations whose
+     * scores are stored contiguously in scores[0, n). The index of the
+     * winner of each of the n_select tournaments is written to
+     * winners[0, n_select); as above, ties go to the contestant drawn
+     * first.
+     *
+     * The tournaments are played by blocks of batch_size. For each
+     * block the t_size contestants of every tournament are drawn at
+     * once with fill_randint, then their scores are gathered and the
+     * winners reduced contestant by contestant, across all the
+     * tournaments of the block, which the compiler vectorizes.
+     *
+     * Each block draws from its own stream, derived from a seed taken
+     * from rng, so the blocks can be played in parallel (if parallel
+     * is true, with OpenMP) and the winners do not depend on the
+     * number of threads.
+     */
+    template<typename ScoreT>
+    void select_batch(const ScoreT* scores, size_t n,
+                      unsigned* winners, size_t n_select,
+                      bool parallel = false) const
+    {
+        OC_ASSERT(0 < n and n <= size_t(std::numeric_limits<int>::max()),
+                  "tournament_selection - population size out of range");
+        // Drawn in two statements so the halves come in a fixed order.
+        const uint64_t seed_hi = rng();
+        const uint64_t seed_lo = rng();
+        const uint64_t seed = (seed_hi << 32) | seed_lo;
+        const long n_blocks = (n_select + batch_size - 1) / batch_size;
+
+        #pragma omp parallel if(parallel)
+        {
+            std::vector<int> idx(t_size * batch_size);
+            std::vector<ScoreT> best(batch_size);
+
+            #pragma omp for schedule(static)
+            for (long b = 0; b < n_blocks; b++) {
+                size_t first = b * batch_size,
+                    k = std::min(batch_size, n_select - first);
+                xoshiro256pp_x4 gen(task_rng(seed, b)());
+                for (unsigned c = 0; c < t_size; c++)
+                    fill_randint(&idx[c * batch_size], k, int(n), gen);
+
+                unsigned* win = winners + first;
+                const int* contestant = idx.data();
+                #pragma omp simd
+                for (size_t j = 0; j < k; j++) {
+                    win[j] = contestant[j];
+                    best[j] = scores[contestant[j]];
+                }
+                for (unsigned c = 1; c < t_size; c++) {
+                    contestant = &idx[c * batch_size];
+                    #pragma omp simd
+                    for (size_t j = 0; j < k; j++) {
+                        ScoreT s = scores[contestant[j]];
+                        bool better = best[j] < s;
+                        win[j] = better ? unsigned(contestant[j]) : win[j];
+                        best[j] = better ? s : best[j];
+                    }
+                }
+            }
+        }
+    }
+
+    //! Number of tournaments played per block by select_batch.
+    static constexpr size_t batch_size = 1024;
 };
 
 /**
@@ -109,6 +181,26 @@ It roulette_select(It from, It to, RandGen& rng = randGen())
                            rng);
 }
 
+/**
+ * Same as above, but with the weights of [from, to) precomputed in a
+ * sampler (alias_sampler or fenwick_sampler), so that each draw takes
+ * O(1) or O(log n) instead of a scan of the whole range.
+ */
+template<typename It, typename Sampler>
+It roulette_select(It from, const Sampler& sampler, RandGen& rng = randGen())
+{
+    return std::next(from, sampler(rng));
+}
+
+/**
+ * Select nodes, of a given arity, with probability proportional to
+ * their integer weight, and arities with probability proportional to
+ * the total weight of their nodes.
+ *
+ * Weights are kept in fenwick_samplers, so add() and both selections
+ * take O(log n), and make the same choices as roulette_select over
+ * the same weights would.
+ */
 template<typename NodeT>
 class NodeSelector
 {
@@ -120,33 +212,30 @@ public:
     }
 
     NodeT select(int arity) const {
-        return roulette_select
-               (boost::make_transform_iterator
-                (_byArity[arity].begin(), select2nd<NodeT, int>),
-                boost::make_transform_iterator
-                (_byArity[arity].end(), select2nd<NodeT, int>),
-                _aritySums[arity], rng).base()->first;
+        // Like roulette_select, pick the first node if all weigh 0.
+        const fenwick_sampler<int>& w = _nodeWeights[arity];
+        return _byArity[arity][w.total() > 0 ? w(rng) : 0].first;
     }
     int select_arity(int from) const {
-        //could make this slightly faster by caching the partial sums,
-        //but who cares?
-        return distance(_aritySums.begin(),
-                        roulette_select(_aritySums.begin() + from,
-                                        _aritySums.end(), rng));
+        return _arityWeights(from, rng);
     }
 
     void add(const NodeT& n, int arity, int prob) {
         if ((int)_byArity.size() <= arity) {
             _byArity.resize(arity + 1);
-            _aritySums.resize(arity + 1, 0);
+            _nodeWeights.resize(arity + 1);
+            while ((int)_arityWeights.size() <= arity)
+                _arityWeights.push_back(0);
         }
-        _byArity[arity].push_back(make_pair(n, prob));
-        _aritySums[arity] += prob;
+        _byArity[arity].push_back(std::make_pair(n, prob));
+        _nodeWeights[arity].push_back(prob);
+        _arityWeights.add(arity, prob);
     }
 private:
     RandGen& rng;
     std::vector<PSeq> _byArity;
-    std::vector<int> _aritySums;
+    std::vector<fenwick_sampler<int> > _nodeWeights;
+    fenwick_sampler<int> _arityWeights;
 };
 
 /** @}*/
@@ -0,0 +1,360 @@
+/*
+ * opencog/util/simd_distance.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "simd_distance.h"
+
+#include <algorithm>
+#include <cmath>
+
+// GCC builds one clone of the functions so marked per target, and
+// resolves calls to the best one for the CPU at load time.
+#if defined(__GNUC__) && !defined(__clang__) && \
+    defined(__x86_64__) && defined(__linux__)
+#define OC_SIMD_CLONES \
+    __attribute__((target_clones("avx512f", "avx2", "default")))
+#define OC_POPCNT_CLONES \
+    __attribute__((target_clones("popcnt", "default")))
+#define OC_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define OC_SIMD_CLONES
+#define OC_POPCNT_CLONES
+#define OC_ALWAYS_INLINE inline
+#endif
+
+namespace opencog
+{
+
+namespace {
+
+// Same as in numeric.h
+const double distance_epsilon = 1e-32;
+
+// Number of partial sums kept by the kernels: two AVX-512 registers
+// worth. Each partial sum only depends on itself, so the loops over
+// them vectorize without reassociating any floating point sum.
+template<typename T>
+constexpr size_t lanes() { return 128 / sizeof(T); }
+
+template<typename T>
+OC_ALWAYS_INLINE T l1_(const T* a, const T* b, size_t n)
+{
+    constexpr size_t L = lanes<T>();
+    T acc[L] = {};
+    size_t i = 0;
+    for (; i + L <= n; i += L)
+#pragma GCC unroll 32
+        for (size_t j = 0; j < L; j++)
+            acc[j] += std::fabs(a[i + j] - b[i + j]);
+    T sum = 0;
+    for (size_t j = 0; j < L; j++) sum += acc[j];
+    for (; i < n; i++) sum += std::fabs(a[i] - b[i]);
+    return sum;
+}
+
+template<typename T>
+OC_ALWAYS_INLINE T l2_sq_(const T* a, const T* b, size_t n)
+{
+    constexpr size_t L = lanes<T>();
+    T acc[L] = {};
+    size_t i = 0;
+    for (; i + L <= n; i += L)
+#pragma GCC unroll 32
+        for (size_t j = 0; j < L; j++) {
+            T d = a[i + j] - b[i + j];
+            acc[j] += d * d;
+        }
+    T sum = 0;
+    for (size_t j = 0; j < L; j++) sum += acc[j];
+    for (; i < n; i++) sum += (a[i] - b[i]) * (a[i] - b[i]);
+    return sum;
+}
+
+template<typename T>
+OC_ALWAYS_INLINE T linf_(const T* a, const T* b, size_t n)
+{
+    constexpr size_t L = lanes<T>();
+    T acc[L] = {};
+    size_t i = 0;
+    for (; i + L <= n; i += L)
+#pragma GCC unroll 32
+        for (size_t j = 0; j < L; j++) {
+            T d = std::fabs(a[i + j] - b[i + j]);
+            acc[j] = acc[j] < d ? d : acc[j];
+        }
+    T res = 0;
+    for (size_t j = 0; j < L; j++) res = std::max(res, acc[j]);
+    for (; i < n; i++) res = std::max(res, T(std::fabs(a[i] - b[i])));
+    return res;
+}
+
+//! a.b and b.b
+template<typename T>
+OC_ALWAYS_INLINE void dot2_(const T* a, const T* b, size_t n, T& ab, T& bb)
+{
+    constexpr size_t L = lanes<T>() / 2;
+    T acc_ab[L] = {}, acc_bb[L] = {};
+    size_t i = 0;
+    for (; i + L <= n; i += L)
+#pragma GCC unroll 32
+        for (size_t j = 0; j < L; j++) {
+            acc_ab[j] += a[i + j] * b[i + j];
+            acc_bb[j] += b[i + j] * b[i + j];
+        }
+    ab = bb = 0;
+    for (size_t j = 0; j < L; j++) {
+        ab += acc_ab[j];
+        bb += acc_bb[j];
+    }
+    for (; i < n; i++) {
+        ab += a[i] * b[i];
+        bb += b[i] * b[i];
+    }
+}
+
+template<typename T>
+OC_ALWAYS_INLINE T sum_sq_(const T* a, size_t n)
+{
+    T ab, aa;
+    dot2_(a, a, n, ab, aa);
+    return aa;
+}
+
+template<typename T>
+OC_ALWAYS_INLINE void dot3_(const T* a, const T* b, size_t n,
+                            T& ab, T& aa, T& bb)
+{
+    constexpr size_t L = lanes<T>() / 2;
+    T acc_ab[L] = {}, acc_aa[L] = {}, acc_bb[L] = {};
+    size_t i = 0;
+    for (; i + L <= n; i += L)
+#pragma GCC unroll 32
+        for (size_t j = 0; j < L; j++) {
+            acc_ab[j] += a[i + j] * b[i + j];
+            acc_aa[j] += a[i + j] * a[i + j];
+            acc_bb[j] += b[i + j] * b[i + j];
+        }
+    ab = aa = bb = 0;
+    for (size_t j = 0; j < L; j++) {
+        ab += acc_ab[j];
+        aa += acc_aa[j];
+        bb += acc_bb[j];
+    }
+    for (; i < n; i++) {
+        ab += a[i] * b[i];
+        aa += a[i] * a[i];
+        bb += b[i] * b[i];
+    }
+}
+
+template<typename T>
+T tanimoto_(T ab, T aa, T bb)
+{
+    T numerator = aa + bb - ab;
+    return numerator >= T(distance_epsilon) ? 1 - ab / numerator : 0;
+}
+
+template<typename T>
+T angular_(T ab, T aa, T bb, bool pos_n_neg)
+{
+    T numerator = std::sqrt(aa * bb);
+    if (numerator < T(distance_epsilon)) return 0;
+    T r = std::min(std::max(ab / numerator, T(-1)), T(1));
+    return (pos_n_neg ? 1 : 2) * std::acos(r) / T(M_PI);
+}
+
+//! General p, as in numeric.h
+template<typename T>
+T p_norm_(const T* a, const T* b, size_t n, double p)
+{
+    T sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        T diff = std::fabs(a[i] - b[i]);
+        if (0 < diff) sum += std::pow(diff, p);
+    }
+    return std::pow(sum, 1.0 / p);
+}
+
+template<typename T>
+OC_ALWAYS_INLINE void p_norm_batch_(const T* q, const T* data, size_t n_vec,
+                                   size_t dim, double p, T* out)
+{
+    if (1.0 == p)
+        for (size_t i = 0; i < n_vec; i++)
+            out[i] = l1_(q, data + i * dim, dim);
+    else if (2.0 == p)
+        for (size_t i = 0; i < n_vec; i++)
+            out[i] = std::sqrt(l2_sq_(q, data + i * dim, dim));
+    else if (0.0 >= p)
+        for (size_t i = 0; i < n_vec; i++)
+            out[i] = linf_(q, data + i * dim, dim);
+    else
+        for (size_t i = 0; i < n_vec; i++)
+            out[i] = p_norm_(q, data + i * dim, dim, p);
+}
+
+template<typename T>
+OC_ALWAYS_INLINE void tanimoto_batch_(const T* q, const T* data, size_t n_vec,
+                                     size_t dim, T* out)
+{
+    T qq = sum_sq_(q, dim);
+    for (size_t i = 0; i < n_vec; i++) {
+        T qx, xx;
+        dot2_(q, data + i * dim, dim, qx, xx);
+        out[i] = tanimoto_(qx, qq, xx);
+    }
+}
+
+template<typename T>
+OC_ALWAYS_INLINE void angular_batch_(const T* q, const T* data, size_t n_vec,
+                                    size_t dim, T* out, bool pos_n_neg)
+{
+    T qq = sum_sq_(q, dim);
+    for (size_t i = 0; i < n_vec; i++) {
+        T qx, xx;
+        dot2_(q, data + i * dim, dim, qx, xx);
+        out[i] = angular_(qx, qq, xx, pos_n_neg);
+    }
+}
+
+OC_ALWAYS_INLINE double tanimoto_bits_(const uint64_t* a, const uint64_t* b,
+                                       size_t n_words)
+{
+    uint64_t inter = 0, uni = 0;
+    for (size_t i = 0; i < n_words; i++) {
+        inter += __builtin_popcountll(a[i] & b[i]);
+        uni += __builtin_popcountll(a[i] | b[i]);
+    }
+    return uni ? 1 - double(inter) / double(uni) : 0;
+}
+
+} // ~namespace
+
+OC_SIMD_CLONES
+float l1_distance(const float* a, const float* b, size_t n)
+{
+    return l1_(a, b, n);
+}
+
+OC_SIMD_CLONES
+double l1_distance(const double* a, const double* b, size_t n)
+{
+    return l1_(a, b, n);
+}
+
+OC_SIMD_CLONES
+float l2_distance_sq(const float* a, const float* b, size_t n)
+{
+    return l2_sq_(a, b, n);
+}
+
+OC_SIMD_CLONES
+double l2_distance_sq(const double* a, const double* b, size_t n)
+{
+    return l2_sq_(a, b, n);
+}
+
+OC_SIMD_CLONES
+float linf_distance(const float* a, const float* b, size_t n)
+{
+    return linf_(a, b, n);
+}
+
+OC_SIMD_CLONES
+double linf_distance(const double* a, const double* b, size_t n)
+{
+    return linf_(a, b, n);
+}
+
+OC_SIMD_CLONES
+void dot_products(const float* a, const float* b, size_t n,
+                  float& ab, float& aa, float& bb)
+{
+    dot3_(a, b, n, ab, aa, bb);
+}
+
+OC_SIMD_CLONES
+void dot_products(const double* a, const double* b, size_t n,
+                  double& ab, double& aa, double& bb)
+{
+    dot3_(a, b, n, ab, aa, bb);
+}
+
+OC_POPCNT_CLONES
+double tanimoto_distance_bits(const uint64_t* a, const uint64_t* b,
+                              size_t n_words)
+{
+    return tanimoto_bits_(a, b, n_words);
+}
+
+OC_SIMD_CLONES
+void p_norm_distance_batch(const float* q, const float* data,
+                           size_t n_vec, size_t dim, double p, float* out)
+{
+    p_norm_batch_(q, data, n_vec, dim, p, out);
+}
+
+OC_SIMD_CLONES
+void p_norm_distance_batch(const double* q, const double* data,
+                           size_t n_vec, size_t dim, double p, double* out)
+{
+    p_norm_batch_(q, data, n_vec, dim, p, out);
+}
+
+OC_SIMD_CLONES
+void tanimoto_distance_batch(const float* q, const float* data,
+                             size_t n_vec, size_t dim, float* out)
+{
+    tanimoto_batch_(q, data, n_vec, dim, out);
+}
+
+OC_SIMD_CLONES
+void tanimoto_distance_batch(const double* q, const double* data,
+                             size_t n_vec, size_t dim, double* out)
+{
+    tanimoto_batch_(q, data, n_vec, dim, out);
+}
+
+OC_SIMD_CLONES
+void angular_distance_batch(const float* q, const float* data,
+                            size_t n_vec, size_t dim, float* out,
+                            bool pos_n_neg)
+{
+    angular_batch_(q, data, n_vec, dim, out, pos_n_neg);
+}
+
+OC_SIMD_CLONES
+void angular_distance_batch(const double* q, const double* data,
+                            size_t n_vec, size_t dim, double* out,
+                            bool pos_n_neg)
+{
+    angular_batch_(q, data, n_vec, dim, out, pos_n_neg);
+}
+
+OC_POPCNT_CLONES
+void tanimoto_distance_bits_batch(const uint64_t* q, const uint64_t* data,
+                                  size_t n_vec, size_t n_words, double* out)
+{
+    for (size_t i = 0; i < n_vec; i++)
+        out[i] = tanimoto_bits_(q, data + i * n_words, n_words);
+}
+
+} // ~namespace opencog
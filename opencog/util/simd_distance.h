@@ -0,0 +1,104 @@
+/*
+ * opencog/util/simd_distance.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_SIMD_DISTANCE_H
+#define _OPENCOG_SIMD_DISTANCE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * \file simd_distance.h
+ *
+ * Distance kernels over contiguous float and double arrays, and over
+ * bit-packed vectors.
+ *
+ * On x86-64 Linux with GCC, each kernel is compiled for AVX-512, for
+ * AVX2 and for the baseline ISA, and the best version for the running
+ * CPU is picked when the library is loaded; elsewhere only the
+ * baseline version is built. The kernels keep many partial sums, so
+ * their results can differ from a plain loop by rounding errors.
+ *
+ * p_norm_distance, tanimoto_distance and angular_distance of
+ * numeric.h use them for std::vector<float> and std::vector<double>,
+ * when the distance is not asked in a more precise type.
+ * The batch versions compare one query to n_vec vectors of dim
+ * elements, stored one after the other in data.
+ */
+
+namespace opencog
+{
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+//! sum_i |a_i - b_i|
+float l1_distance(const float* a, const float* b, size_t n);
+double l1_distance(const double* a, const double* b, size_t n);
+
+//! sum_i (a_i - b_i)^2
+float l2_distance_sq(const float* a, const float* b, size_t n);
+double l2_distance_sq(const double* a, const double* b, size_t n);
+
+//! max_i |a_i - b_i|
+float linf_distance(const float* a, const float* b, size_t n);
+double linf_distance(const double* a, const double* b, size_t n);
+
+//! a.b, a.a and b.b, in a single pass.
+void dot_products(const float* a, const float* b, size_t n,
+                  float& ab, float& aa, float& bb);
+void dot_products(const double* a, const double* b, size_t n,
+                  double& ab, double& aa, double& bb);
+
+//! Jaccard distance between two sets of bits, packed in n_words
+//! words: 1 - |a & b| / |a | b|, and 0 if both are empty.
+double tanimoto_distance_bits(const uint64_t* a, const uint64_t* b,
+                              size_t n_words);
+
+//! out[i] = p_norm_distance(q, data[i], p), as in numeric.h.
+void p_norm_distance_batch(const float* q, const float* data,
+                           size_t n_vec, size_t dim, double p, float* out);
+void p_norm_distance_batch(const double* q, const double* data,
+                           size_t n_vec, size_t dim, double p, double* out);
+
+//! out[i] = tanimoto_distance(q, data[i]), as in numeric.h.
+void tanimoto_distance_batch(const float* q, const float* data,
+                             size_t n_vec, size_t dim, float* out);
+void tanimoto_distance_batch(const double* q, const double* data,
+                             size_t n_vec, size_t dim, double* out);
+
+//! out[i] = angular_distance(q, data[i], pos_n_neg), as in numeric.h.
+void angular_distance_batch(const float* q, const float* data,
+                            size_t n_vec, size_t dim, float* out,
+                            bool pos_n_neg = true);
+void angular_distance_batch(const double* q, const double* data,
+                            size_t n_vec, size_t dim, double* out,
+                            bool pos_n_neg = true);
+
+//! out[i] = tanimoto_distance_bits(q, data[i], n_words).
+void tanimoto_distance_bits_batch(const uint64_t* q, const uint64_t* data,
+                                  size_t n_vec, size_t n_words, double* out);
+
+/** @}*/
+} // ~namespace opencog
+
+#endif // _OPENCOG_SIMD_DISTANCE_H
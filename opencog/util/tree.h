@@ -72,6 +72,7 @@
 #include <sstream>
 #include <exception>
 #include <boost/lexical_cast.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/iterator/counting_iterator.hpp>
 #include <functional>
 
@@ -110,20 +111,34 @@ void destructor(T1* p)
 
 }
 
+/// Cached subtree hash of the nodes of hashed trees; empty otherwise,
+/// so that the other trees don't pay for it.
+template<bool Hashed>
+struct tree_node_hash_ {};
+
+template<>
+struct tree_node_hash_<true> {
+    std::size_t hash_cache; // subtree hash, 0 if not computed yet
+};
+
 /// A node in the tree, combining links to other nodes as well as the actual data.
-template<class T>
-class tree_node_ { // size: 5*4=20 bytes (on 32 bit arch), can be reduced by 8.
+/// If Hashed, the node also caches the hash of its subtree (see hashed_tree).
+template<class T, bool Hashed = false>
+class tree_node_ : public tree_node_hash_<Hashed> { // size: 5*4=20 bytes (on 32 bit arch), can be reduced by 8.
 public:
-    tree_node_<T> *parent;
-    tree_node_<T> *first_child, *last_child;
-    tree_node_<T> *prev_sibling, *next_sibling;
+    static const bool hashed = Hashed;
+    tree_node_<T, Hashed> *parent;
+    tree_node_<T, Hashed> *first_child, *last_child;
+    tree_node_<T, Hashed> *prev_sibling, *next_sibling;
     T data;
 }; // __attribute__((packed));
 
+/// The nodes are those allocated by tree_node_allocator: tree_node_<T>,
+/// or tree_node_<T, true> to cache subtree hashes.
 template <class T, class tree_node_allocator = std::allocator<tree_node_<T> > >
 class tree {
 protected:
-    typedef tree_node_<T> tree_node;
+    typedef typename tree_node_allocator::value_type tree_node;
 public:
     /// Value of the data stored at a node.
     typedef T value_type;
@@ -499,6 +514,19 @@ public:
     int      subtree_size(const iterator_base& it) const;
     /// Check if tree is empty.
     bool     empty() const;
+    /// Merkle-style hash of the subtree 'it'. Only the nodes of hashed
+    /// trees (see hashed_tree) cache it, and otherwise it is computed
+    /// anew at each call, in O(size). The cache is kept up to date by
+    /// all structural modifications, so re-hashing after a local edit
+    /// costs O(depth). Computing a hash fills the cache, so concurrent
+    /// readers should either synchronize or warm the cache first (e.g.
+    /// by calling hash()).
+    std::size_t subtree_hash(const iterator_base& it) const;
+    /// Combined subtree_hash() of all the roots.
+    std::size_t hash() const;
+    /// Forget the cached hash of the node at 'it' (and of its ancestors).
+    /// Must be called after modifying the data of a node in place.
+    void     invalidate_hash(const iterator_base& it);
     /// Compute the depth to the root.
     int      depth(const iterator_base&) const;
     /// Count the number of children of node at position.
@@ -551,6 +579,8 @@ public:
 private:
     tree_node_allocator alloc_;
     void head_initialise_();
+    void invalidate_hash_(tree_node *);
+    static void clear_hash_(tree_node *);
     void copy_(const tree<T, tree_node_allocator>& other);
 
     /// Comparator class for two nodes of a tree (used for sorting and searching).
@@ -581,6 +611,12 @@ private:
     };
 };
 
+/// A tree whose nodes cache the hash of their subtree, so that
+/// re-hashing after a local edit costs O(depth) rather than O(size),
+/// at the cost of one size_t per node.
+template <class T>
+using hashed_tree = tree<T, std::allocator<tree_node_<T, true> > >;
+
 //template <class T, class tree_node_allocator>
 //class iterator_base_less {
 // public:
@@ -718,12 +754,14 @@ void tree<T, tree_node_allocator>::head_initialise_()
     head->last_child=0;
     head->prev_sibling=0; //head;
     head->next_sibling=feet; //head;
+    clear_hash_(head);
 
     feet->parent=0;
     feet->first_child=0;
     feet->last_child=0;
     feet->prev_sibling=head;
     feet->next_sibling=0;
+    clear_hash_(feet);
 }
 
 template <class T, class tree_node_allocator>
@@ -765,9 +803,20 @@ void tree<T, tree_node_allocator>::copy_(const tree<T, tree_node_allocator>& oth
 template <class T, class tree_node_allocator>
 void tree<T, tree_node_allocator>::clear()
 {
-    if(head)
-        while(head->next_sibling!=feet)
-            erase(pre_order_iterator(head->next_sibling));
+    if(head) {
+        // Free all roots in one sweep; there is no point in re-linking
+        // siblings that are about to be freed as well.
+        tree_node *cur=head->next_sibling;
+        while(cur!=feet) {
+            tree_node *next=cur->next_sibling;
+            erase_children(pre_order_iterator(cur));
+            kp::destructor(&cur->data);
+            alloc_.deallocate(cur,1);
+            cur=next;
+        }
+        head->next_sibling=feet;
+        feet->prev_sibling=head;
+    }
 }
 
 template<class T, class tree_node_allocator>
@@ -785,6 +834,7 @@ void tree<T, tree_node_allocator>::erase_children(const iterator_base& it)
     }
     it.node->first_child=0;
     it.node->last_child=0;
+    invalidate_hash_(it.node);
 }
 
 template<class T, class tree_node_allocator>
@@ -810,6 +860,7 @@ iter tree<T, tree_node_allocator>::erase(iter it)
         cur->next_sibling->prev_sibling=cur->prev_sibling;
     }
 
+    invalidate_hash_(cur->parent);
     kp::destructor(&cur->data);
     alloc_.deallocate(cur,1);
     return ret;
@@ -1012,6 +1063,7 @@ iter tree<T, tree_node_allocator>::append_child(iter position)
     kp::constructor(&tmp->data);
     tmp->first_child=0;
     tmp->last_child=0;
+    clear_hash_(tmp);
 
     tmp->parent=position.node;
     if(position.node->last_child!=0) {
@@ -1023,6 +1075,7 @@ iter tree<T, tree_node_allocator>::append_child(iter position)
     tmp->prev_sibling=position.node->last_child;
     position.node->last_child=tmp;
     tmp->next_sibling=0;
+    invalidate_hash_(position.node);
     return tmp;
 }
 
@@ -1037,6 +1090,7 @@ iter tree<T, tree_node_allocator>::prepend_child(iter position)
     kp::constructor(&tmp->data);
     tmp->first_child=0;
     tmp->last_child=0;
+    clear_hash_(tmp);
 
     tmp->parent=position.node;
     if(position.node->first_child!=0) {
@@ -1048,6 +1102,7 @@ iter tree<T, tree_node_allocator>::prepend_child(iter position)
     tmp->next_sibling=position.node->first_child;
     position.node->first_child=tmp;
     tmp->prev_sibling=0;
+    invalidate_hash_(position.node);
     return tmp;
 }
 
@@ -1072,8 +1127,8 @@ template <class T, class tree_node_allocator>
 template <class iter>
 iter tree<T, tree_node_allocator>::append_child(iter position, const T& x)
 {
-    tree_assert(position.node != nullptr);
-    tree_assert(position.node->data != nullptr);
+    tree_assert(position.node!=head);
+    tree_assert(position.node);
     sibling_iterator tmp = append_child(position);
     *tmp = x;
     return tmp;
@@ -1090,6 +1145,7 @@ iter tree<T, tree_node_allocator>::prepend_child(iter position, const T& x)
     kp::constructor(&tmp->data, x);
     tmp->first_child=0;
     tmp->last_child=0;
+    clear_hash_(tmp);
 
     tmp->parent=position.node;
     if(position.node->first_child!=0) {
@@ -1101,6 +1157,7 @@ iter tree<T, tree_node_allocator>::prepend_child(iter position, const T& x)
     tmp->next_sibling=position.node->first_child;
     position.node->first_child=tmp;
     tmp->prev_sibling=0;
+    invalidate_hash_(position.node);
     return tmp;
 }
 
@@ -1211,6 +1268,7 @@ iter tree<T, tree_node_allocator>::insert(iter position, const T& x)
     kp::constructor(&tmp->data, x);
     tmp->first_child=0;
     tmp->last_child=0;
+    clear_hash_(tmp);
 
     tmp->parent=position.node->parent;
     tmp->next_sibling=position.node;
@@ -1223,6 +1281,7 @@ iter tree<T, tree_node_allocator>::insert(iter position, const T& x)
     }
     else
         tmp->prev_sibling->next_sibling=tmp;
+    invalidate_hash_(tmp->parent);
     return tmp;
 }
 
@@ -1233,6 +1292,7 @@ typename tree<T, tree_node_allocator>::sibling_iterator tree<T, tree_node_alloca
     kp::constructor(&tmp->data, x);
     tmp->first_child=0;
     tmp->last_child=0;
+    clear_hash_(tmp);
 
     tmp->next_sibling=position.node;
     if(position.node==0) { // iterator points to end of a subtree
@@ -1252,6 +1312,7 @@ typename tree<T, tree_node_allocator>::sibling_iterator tree<T, tree_node_alloca
     }
     else
         tmp->prev_sibling->next_sibling=tmp;
+    invalidate_hash_(tmp->parent);
     return tmp;
 }
 
@@ -1263,6 +1324,7 @@ iter tree<T, tree_node_allocator>::insert_after(iter position, const T& x)
     kp::constructor(&tmp->data, x);
     tmp->first_child=0;
     tmp->last_child=0;
+    clear_hash_(tmp);
 
     tmp->parent=position.node->parent;
     tmp->prev_sibling=position.node;
@@ -1276,6 +1338,7 @@ iter tree<T, tree_node_allocator>::insert_after(iter position, const T& x)
     else {
         tmp->next_sibling->prev_sibling=tmp;
     }
+    invalidate_hash_(tmp->parent);
     return tmp;
 }
 
@@ -1286,6 +1349,7 @@ iter tree<T, tree_node_allocator>::insert_above(iter position, const T& x) {
 
     tree_node* tmp = alloc_.allocate(1,0);
     kp::constructor(&tmp->data, x);
+    clear_hash_(tmp);
 
     tmp->first_child=dst;
     tmp->last_child=dst;
@@ -1307,6 +1371,7 @@ iter tree<T, tree_node_allocator>::insert_above(iter position, const T& x) {
     dst->parent=tmp;
     dst->prev_sibling=0;
     dst->next_sibling=0;
+    invalidate_hash_(tmp->parent);
 
     return tmp;
 }
@@ -1347,6 +1412,7 @@ iter tree<T, tree_node_allocator>::replace(iter position, const T& x)
 {
     kp::destructor(&position.node->data);
     kp::constructor(&position.node->data, x);
+    invalidate_hash_(position.node);
     return position;
 }
 
@@ -1369,6 +1435,7 @@ iter tree<T, tree_node_allocator>::replace(iter position, const iterator_base& f
     kp::constructor(&tmp->data, (*from));
     tmp->first_child=0;
     tmp->last_child=0;
+    clear_hash_(tmp);
     if(current_to->prev_sibling==0) {
         current_to->parent->first_child=tmp;
     }
@@ -1384,6 +1451,7 @@ iter tree<T, tree_node_allocator>::replace(iter position, const iterator_base& f
     }
     tmp->next_sibling=current_to->next_sibling;
     tmp->parent=current_to->parent;
+    invalidate_hash_(tmp->parent);
     kp::destructor(&current_to->data);
     alloc_.deallocate(current_to,1);
     current_to=tmp;
@@ -1483,6 +1551,7 @@ iter tree<T, tree_node_allocator>::flatten(iter position)
     position.node->next_sibling->prev_sibling=position.node;
     position.node->first_child=0;
     position.node->last_child=0;
+    invalidate_hash_(position.node);
 
     return position;
 }
@@ -1498,6 +1567,7 @@ iter tree<T, tree_node_allocator>::reparent(iter position, sibling_iterator begi
     tree_assert(first!=position.node);
 
     if(begin==end) return begin;
+    invalidate_hash_(first->parent);
     // determine last node
     while((++begin)!=end) {
         last=last->next_sibling;
@@ -1533,6 +1603,7 @@ iter tree<T, tree_node_allocator>::reparent(iter position, sibling_iterator begi
         if(pos==last) break;
         pos=pos->next_sibling;
     }
+    invalidate_hash_(position.node);
 
     return first;
 }
@@ -1569,6 +1640,7 @@ template <typename iter> iter tree<T, tree_node_allocator>::move_after(iter targ
             return source;
 
     // take src out of the tree
+    invalidate_hash_(src->parent);
     if(src->prev_sibling!=0) src->prev_sibling->next_sibling=src->next_sibling;
     else                     src->parent->first_child=src->next_sibling;
     if(src->next_sibling!=0) src->next_sibling->prev_sibling=src->prev_sibling;
@@ -1581,6 +1653,7 @@ template <typename iter> iter tree<T, tree_node_allocator>::move_after(iter targ
     dst->next_sibling=src;
     src->prev_sibling=dst;
     src->parent=dst->parent;
+    invalidate_hash_(src->parent);
     return src;
 }
 
@@ -1598,6 +1671,7 @@ template <typename iter> iter tree<T, tree_node_allocator>::move_before(iter tar
             return source;
 
     // take src out of the tree
+    invalidate_hash_(src->parent);
     if(src->prev_sibling!=0) src->prev_sibling->next_sibling=src->next_sibling;
     else                     src->parent->first_child=src->next_sibling;
     if(src->next_sibling!=0) src->next_sibling->prev_sibling=src->prev_sibling;
@@ -1610,6 +1684,7 @@ template <typename iter> iter tree<T, tree_node_allocator>::move_before(iter tar
     dst->prev_sibling=src;
     src->next_sibling=dst;
     src->parent=dst->parent;
+    invalidate_hash_(src->parent);
     return src;
 }
 
@@ -1634,6 +1709,7 @@ typename tree<T, tree_node_allocator>::sibling_iterator tree<T, tree_node_alloca
             return source;
 
     // take src out of the tree
+    invalidate_hash_(src->parent);
     if(src->prev_sibling!=0) src->prev_sibling->next_sibling=src->next_sibling;
     else                     src->parent->first_child=src->next_sibling;
     if(src->next_sibling!=0) src->next_sibling->prev_sibling=src->prev_sibling;
@@ -1649,6 +1725,7 @@ typename tree<T, tree_node_allocator>::sibling_iterator tree<T, tree_node_alloca
         src->parent=dst->parent;
     }
     src->next_sibling=dst;
+    invalidate_hash_(src->parent);
     return src;
 }
 
@@ -1671,6 +1748,7 @@ template <typename iter> iter tree<T, tree_node_allocator>::move_ontop(iter targ
     erase(target);
 
     // take src out of the tree
+    invalidate_hash_(src->parent);
     if(src->prev_sibling!=0) src->prev_sibling->next_sibling=src->next_sibling;
     else                     src->parent->first_child=src->next_sibling;
     if(src->next_sibling!=0) src->next_sibling->prev_sibling=src->prev_sibling;
@@ -1684,6 +1762,7 @@ template <typename iter> iter tree<T, tree_node_allocator>::move_ontop(iter targ
     src->prev_sibling=b_prev_sibling;
     src->next_sibling=b_next_sibling;
     src->parent=b_parent;
+    invalidate_hash_(b_parent);
     return src;
 }
 
@@ -1737,6 +1816,7 @@ void tree<T, tree_node_allocator>::sort(sibling_iterator from, sibling_iterator
     --it2;
 
     // prev and next are the nodes before and after the sorted range
+    invalidate_hash_(from.node->parent);
     tree_node *prev=from.node->prev_sibling;
     tree_node *next=it2.node->next_sibling;
     typename std::multiset<tree_node *, compare_nodes<StrictWeakOrdering> >::iterator nit=nodes.begin(), eit=nodes.end();
@@ -1823,6 +1903,7 @@ void tree<T, tree_node_allocator>::sort_on_subtrees(sibling_iterator from,
     --it2;
 
     // prev and next are the nodes before and after the sorted range
+    invalidate_hash_(from.node->parent);
     tree_node *prev=from.node->prev_sibling;
     tree_node *next=it2.node->next_sibling;
     typename mset::iterator nit=nodes.begin(), eit=nodes.end();
@@ -1947,6 +2028,63 @@ bool tree<T, tree_node_allocator>::empty() const
     return (it==eit);
 }
 
+template <class T, class tree_node_allocator>
+void tree<T, tree_node_allocator>::clear_hash_(tree_node *node)
+{
+    if constexpr (tree_node::hashed)
+        node->hash_cache=0;
+}
+
+template <class T, class tree_node_allocator>
+void tree<T, tree_node_allocator>::invalidate_hash_(tree_node *node)
+{
+    // A node whose hash is unknown has ancestors whose hash is
+    // unknown too, so the walk stops at the first such node; a local
+    // edit costs O(depth) at most, and O(1) if nobody hashed the tree.
+    if constexpr (tree_node::hashed) {
+        while(node!=0 && node->hash_cache!=0) {
+            node->hash_cache=0;
+            node=node->parent;
+        }
+    }
+}
+
+template <class T, class tree_node_allocator>
+void tree<T, tree_node_allocator>::invalidate_hash(const iterator_base& it)
+{
+    invalidate_hash_(it.node);
+}
+
+template <class T, class tree_node_allocator>
+std::size_t tree<T, tree_node_allocator>::subtree_hash(const iterator_base& it) const
+{
+    tree_node *node=it.node;
+    if constexpr (tree_node::hashed) {
+        if(node->hash_cache!=0)
+            return node->hash_cache;
+    }
+
+    std::size_t h=boost::hash<T>()(node->data);
+    boost::hash_combine(h, it.number_of_children());
+    for(tree_node *child=node->first_child; child!=0; child=child->next_sibling)
+        boost::hash_combine(h, subtree_hash(pre_order_iterator(child)));
+
+    // 0 is reserved for 'not computed yet'.
+    if(h==0) h=1;
+    if constexpr (tree_node::hashed)
+        node->hash_cache=h;
+    return h;
+}
+
+template <class T, class tree_node_allocator>
+std::size_t tree<T, tree_node_allocator>::hash() const
+{
+    std::size_t h=0;
+    for(tree_node *root=head->next_sibling; root!=feet; root=root->next_sibling)
+        boost::hash_combine(h, subtree_hash(pre_order_iterator(root)));
+    return h;
+}
+
 template <class T, class tree_node_allocator>
 int tree<T, tree_node_allocator>::depth(const iterator_base& it) const
 {
@@ -2018,6 +2156,7 @@ void tree<T, tree_node_allocator>::swap(sibling_iterator it)
         nxt->next_sibling=it.node;
         it.node->prev_sibling=nxt;
         it.node->next_sibling=nxtnxt;
+        invalidate_hash_(it.node->parent);
     }
 }
 
@@ -2051,6 +2190,8 @@ void tree<T, tree_node_allocator>::swap(iterator one, iterator two)
         two.node->prev_sibling=pre1;
         if(pre1) pre1->next_sibling=two.node;
         else     par1->first_child=two.node;
+        invalidate_hash_(par1);
+        invalidate_hash_(par2);
     }
 }
 
@@ -0,0 +1,264 @@
+/*
+ * opencog/util/tree_allocator.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_TREE_ALLOCATOR_H
+#define _OPENCOG_TREE_ALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <opencog/util/tree.h>
+
+namespace opencog
+{
+/** \addtogroup grp_cogutil
+ *  @{
+ */
+
+namespace detail {
+
+//! Slab of fixed-size blocks, with a free list per thread.
+/**
+ * Blocks are carved out of large slabs, obtained from the global
+ * heap, and recycled through an intrusive free list. Each thread
+ * allocates from, and frees to, its own list, so the fast path takes
+ * no lock. Lists that grow too long spill a batch of blocks to a
+ * process-wide list; threads with an empty list refill from there
+ * before carving a new slab. When a thread exits, its whole list is
+ * handed over to the process-wide one.
+ *
+ * A block may be freed by a thread other than the one that allocated
+ * it; it simply joins the freeing thread's list. For that reason,
+ * slabs are never returned to the operating system: a tree built in
+ * one thread may well outlive that thread.
+ */
+template<size_t Size, size_t Align>
+class block_slab
+{
+    struct free_block { free_block* next; };
+
+    static constexpr size_t round_up(size_t n, size_t a)
+    {
+        return (n + a - 1) / a * a;
+    }
+
+public:
+    static constexpr size_t block_size =
+        round_up(Size < sizeof(free_block) ? sizeof(free_block) : Size,
+                 Align < alignof(free_block) ? alignof(free_block) : Align);
+
+    //! Number of blocks moved at once between thread and global lists.
+    static constexpr size_t batch_size =
+        (64 * 1024) / block_size < 64 ? 64 : (64 * 1024) / block_size;
+
+    static_assert(Align <= alignof(std::max_align_t),
+                  "over-aligned tree nodes are not supported");
+
+private:
+    // A chain of free blocks, with its length.
+    struct chain
+    {
+        free_block* head = nullptr;
+        size_t size = 0;
+    };
+
+    struct global_state
+    {
+        std::mutex mtx;
+        std::vector<chain> batches;
+    };
+
+    // Deliberately leaked, so that trees destroyed during static
+    // destruction still have somewhere to return their nodes.
+    static global_state& global()
+    {
+        static global_state* g = new global_state();
+        return *g;
+    }
+
+    // The list itself is trivially destructible, so that it remains
+    // usable even after the thread's destructors have started to run
+    // (e.g. for trees destroyed during static destruction). A separate
+    // flusher hands the list over to the global one at thread exit.
+    static chain& local()
+    {
+        static thread_local chain c;
+        return c;
+    }
+
+    struct flusher
+    {
+        ~flusher()
+        {
+            chain& c = local();
+            if (0 == c.size) return;
+            global_state& g = global();
+            std::lock_guard<std::mutex> lock(g.mtx);
+            g.batches.push_back(c);
+            c = chain();
+        }
+    };
+
+    // Called whenever the thread's list goes from empty to not-empty.
+    static void register_flusher()
+    {
+        static thread_local flusher f;
+        (void) f;
+    }
+
+    static void refill(chain& c)
+    {
+        register_flusher();
+        global_state& g = global();
+        {
+            std::lock_guard<std::mutex> lock(g.mtx);
+            if (not g.batches.empty()) {
+                c = g.batches.back();
+                g.batches.pop_back();
+                return;
+            }
+        }
+
+        // Carve a fresh slab, threading its blocks into a list.
+        char* slab = static_cast<char*>(::operator new(block_size * batch_size));
+        free_block* head = nullptr;
+        for (size_t i = batch_size; 0 < i; i--) {
+            free_block* b = reinterpret_cast<free_block*>(slab + (i-1) * block_size);
+            b->next = head;
+            head = b;
+        }
+        c.head = head;
+        c.size = batch_size;
+    }
+
+    // Move one batch from the thread's list to the global one.
+    static void spill(chain& c)
+    {
+        chain out;
+        out.head = c.head;
+        out.size = batch_size;
+        free_block* last = c.head;
+        for (size_t i = 1; i < batch_size; i++)
+            last = last->next;
+        c.head = last->next;
+        c.size -= batch_size;
+        last->next = nullptr;
+
+        global_state& g = global();
+        std::lock_guard<std::mutex> lock(g.mtx);
+        g.batches.push_back(out);
+    }
+
+public:
+    static void* allocate()
+    {
+        chain& c = local();
+        if (nullptr == c.head) refill(c);
+        free_block* b = c.head;
+        c.head = b->next;
+        c.size--;
+        return b;
+    }
+
+    static void deallocate(void* p)
+    {
+        chain& c = local();
+        if (0 == c.size) register_flusher();
+        free_block* b = static_cast<free_block*>(p);
+        b->next = c.head;
+        c.head = b;
+        if (2 * batch_size < ++c.size) spill(c);
+    }
+
+    //! Number of free blocks cached by the calling thread.
+    static size_t local_free() { return local().size; }
+};
+
+} // ~namespace detail
+
+//! Node allocator for opencog::tree, backed by a thread-local slab.
+/**
+ * Plugs into the tree_node_allocator parameter of opencog::tree:
+ *
+ * @code
+ * tree<int, tree_node_pool_allocator<tree_node_<int>>> tr;
+ * @endcode
+ *
+ * or simply pooled_tree<int>. Single nodes come from a per-size-class
+ * slab with thread-local free lists (see detail::block_slab), so that
+ * building and destroying many small trees does not hit malloc at all
+ * once the free lists are warm. Requests for more than one node,
+ * which tree never makes, fall back to std::allocator.
+ *
+ * The allocator is stateless; all instances compare equal, so nodes
+ * may be freely moved between trees (splice, move_*, replace ...).
+ */
+template<typename Node>
+class tree_node_pool_allocator
+{
+    typedef detail::block_slab<sizeof(Node), alignof(Node)> slab;
+
+public:
+    typedef Node value_type;
+    typedef Node* pointer;
+    typedef const Node* const_pointer;
+    typedef Node& reference;
+    typedef const Node& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind { typedef tree_node_pool_allocator<U> other; };
+
+    tree_node_pool_allocator() {}
+    template<typename U>
+    tree_node_pool_allocator(const tree_node_pool_allocator<U>&) {}
+
+    Node* allocate(size_t n, const void* = 0)
+    {
+        if (1 == n) return static_cast<Node*>(slab::allocate());
+        return std::allocator<Node>().allocate(n);
+    }
+
+    void deallocate(Node* p, size_t n)
+    {
+        if (1 == n) slab::deallocate(p);
+        else std::allocator<Node>().deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const tree_node_pool_allocator<U>&) const { return true; }
+    template<typename U>
+    bool operator!=(const tree_node_pool_allocator<U>&) const { return false; }
+};
+
+//! opencog::tree whose nodes come from tree_node_pool_allocator.
+template<typename T>
+using pooled_tree = tree<T, tree_node_pool_allocator<tree_node_<T>>>;
+
+/** @}*/
+} // ~namespace opencog
+
+#endif // _OPENCOG_TREE_ALLOCATOR_H
@@ -24,7 +24,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <random>
+#include <stdexcept>
+#include <vector>
 
 namespace opencog {
 /** \addtogroup grp_cogutil
@@ -89,7 +92,8 @@ class zipf_distribution
 		}
 		void reset() {}
 
-		IntType operator()(std::mt19937& rng)
+		template<class URNG>
+		IntType operator()(URNG& rng)
 		{
 			while (true)
 			{
@@ -102,6 +106,38 @@ class zipf_distribution
 			}
 		}
 
+		/// Fill out[0..count) with draws.
+		///
+		/// Same distribution as above, but done a block at a time:
+		/// first all the uniform draws, then H_inv over the whole
+		/// block, in a loop with no branch that the compiler can
+		/// vectorize (given a vector math library, such as glibc's
+		/// libmvec, and -fno-math-errno), then the acceptance tests.
+		/// The first test rejects nothing for most draws; the few
+		/// draws that it does not settle go through the full test,
+		/// and the rejected ones are redrawn one at a time.
+		template<class URNG>
+		void operator()(URNG& rng, IntType* out, size_t count)
+		{
+			static const size_t block = 256;
+			RealType u[block], x[block];
+			for (size_t i = 0; i < count; i += block)
+			{
+				const size_t m = std::min(block, count - i);
+				for (size_t j = 0; j < m; j++)
+					u[j] = dist(rng);
+				H_inv_block(u, x, m);
+				for (size_t j = 0; j < m; j++)
+				{
+					const IntType k = std::round(x[j]);
+					out[i + j] = k;
+					if (k - x[j] <= cut) continue;
+					if (u[j] >= H(k + 0.5) - h(k)) continue;
+					out[i + j] = (*this)(rng);
+				}
+			}
+		}
+
 		/// Returns the parameter the distribution was constructed with.
 		RealType s() const { return _s; }
 		/// Returns the Hurwicz q-deformation parameter.
@@ -195,16 +231,35 @@ class zipf_distribution
 
 			return std::exp(y * log1pxbx(oms * y)) - _q;
 		}
+
+		/** x[i] = H_inv(y[i]) for i in [0,m), with the regime test
+		 * hoisted out of the loop. */
+		void H_inv_block(const RealType* y, RealType* x, size_t m)
+		{
+			if (not spole)
+			{
+#pragma omp simd
+				for (size_t i = 0; i < m; i++)
+					x[i] = std::pow(y[i] * oms, rvs) - _q;
+				return;
+			}
+			for (size_t i = 0; i < m; i++)
+				x[i] = std::exp(y[i] * log1pxbx(oms * y[i])) - _q;
+		}
 };
 
 /**
- * Same API as above, but about 25% faster for N=30,and 10% faster for
- * N=300, and tied with above for N=1000.
+ * Same API as above, but draws from a precomputed alias table
+ * (Walker's method): each draw costs two calls to the generator, one
+ * multiplication and a single access to the table, whatever N.
  *
- * This has a much slower initialization, because of the std::pow()
- * function, and also this will thrash the d-cache for N much greater
- * than N=1000 (because this requires lookup in the std::vector<> array).
- * Results will vary depending on your memory subsystem performance.
+ * The table takes 8 bytes per item (a float probability and a 32-bit
+ * alias, side by side so that a draw touches one cache line), so it is
+ * practical up to N of about 10^9; building it takes O(N) time but no
+ * memory beyond the table, as Zipf weights are decreasing. For small
+ * N this is faster than zipf_distribution; for large N the random
+ * access to the table dominates, and the difference depends on your
+ * memory subsystem.
  */
 template<class IntType = unsigned long, class RealType = double>
 class zipf_table_distribution
@@ -215,26 +270,72 @@ class zipf_table_distribution
 		static_assert(std::numeric_limits<IntType>::is_integer, "");
 		static_assert(!std::numeric_limits<RealType>::is_integer, "");
 
-		/// zipf_table_distribution(N, s)
+		/// zipf_table_distribution(N, s, q)
 		/// Zipf distribution for `N` items, in the range `[1,N]` inclusive.
-		/// The distribution follows the power-law 1/n^s with exponent `s`.
-		/// This uses a table-lookup, and thus provides values more
-		/// quickly than zipf_distribution. However, the table can take
-		/// up a considerable amount of RAM, and initializing this table
-		/// can consume significant time.
+		/// The distribution follows the power-law 1/(n+q)^s with exponent
+		/// `s` and Hurwicz q-deformation `q`.
 		zipf_table_distribution(const IntType n,
 		                        const RealType s=1.0,
 		                        const RealType q=0.0) :
-			_n(init(n,s,q)),
+			_n(n),
 			_s(s),
-			_q(q),
-			_dist(_pdf.begin(), _pdf.end())
-		{}
+			_q(q)
+		{
+			if (-0.5 >= q)
+				throw std::runtime_error("Range error: Parameter q must be greater than -0.5!");
+			if (n < 1 or uint64_t(n) > uint64_t(UINT32_MAX))
+				throw std::runtime_error("Range error: N must be in [1, 2^32)!");
+			init();
+		}
 		void reset() {}
 
-		IntType operator()(std::mt19937& rng)
+		template<class URNG>
+		IntType operator()(URNG& rng)
 		{
-			return _dist(rng);
+			// A 64-bit draw times N: the integer part of the product,
+			// scaled by 2^-64, picks the column, and its fractional
+			// part, uniform in [0,1) given the column, picks between
+			// the column and its alias.
+			// As N < 2^32, the 96-bit product is done in two halves.
+			const uint64_t r = draw64(rng);
+			const uint64_t lo = (r & UINT32_MAX) * uint64_t(_n);
+			const uint64_t hi = (r >> 32) * uint64_t(_n) + (lo >> 32);
+			const uint64_t col = hi >> 32;
+			const uint32_t frac = uint32_t(hi);
+			const float coin = float(frac >> 8) * (1.0f / 16777216.0f);
+			const cell& c = _table[col];
+			return 1 + (coin < c.prob ? col : c.alias);
+		}
+
+		/// Fill out[0..count) with draws.
+		///
+		/// The columns of a whole block are drawn first, and their
+		/// cells prefetched, so that for large N the cache misses of
+		/// the block overlap instead of following one another.
+		template<class URNG>
+		void operator()(URNG& rng, IntType* out, size_t count)
+		{
+			static const size_t block = 64;
+			uint64_t col[block];
+			float coin[block];
+			for (size_t i = 0; i < count; i += block)
+			{
+				const size_t m = std::min(block, count - i);
+				for (size_t j = 0; j < m; j++)
+				{
+					const uint64_t r = draw64(rng);
+					const uint64_t lo = (r & UINT32_MAX) * uint64_t(_n);
+					const uint64_t hi = (r >> 32) * uint64_t(_n) + (lo >> 32);
+					col[j] = hi >> 32;
+					coin[j] = float(uint32_t(hi) >> 8) * (1.0f / 16777216.0f);
+					__builtin_prefetch(&_table[col[j]]);
+				}
+				for (size_t j = 0; j < m; j++)
+				{
+					const cell& c = _table[col[j]];
+					out[i + j] = 1 + (coin[j] < c.prob ? col[j] : c.alias);
+				}
+			}
 		}
 
 		/// Returns the parameter the distribution was constructed with.
@@ -249,20 +350,87 @@ class zipf_table_distribution
 		result_type max() const { return _n; }
 
 	private:
-		std::vector<RealType>               _pdf;  ///< Prob. distribution
-		IntType                             _n;    ///< Number of elements
-		RealType                            _s;    ///< Exponent
-		RealType                            _q;    ///< Hurwicz q
-		std::discrete_distribution<IntType> _dist; ///< Draw generator
-
-		/** Initialize the probability mass function */
-		IntType init(const IntType n, const RealType s, const RealType q)
+		struct cell
+		{
+			float    prob;   ///< Probability of keeping the column
+			uint32_t alias;  ///< Column drawn otherwise
+		};
+
+		std::vector<cell>                   _table; ///< Alias table
+		IntType                             _n;     ///< Number of elements
+		RealType                            _s;     ///< Exponent
+		RealType                            _q;     ///< Hurwicz q
+
+		/** Unnormalized weight of item i+1 */
+		double weight(size_t i) const
+		{
+			return std::pow(_q + double(i + 1), -_s);
+		}
+
+		/** 64 random bits, from one or two calls to the generator */
+		template<class URNG>
+		static uint64_t draw64(URNG& rng)
+		{
+			static_assert(URNG::min() == 0, "");
+			if constexpr (URNG::max() >= UINT64_MAX)
+				return rng();
+			else
+			{
+				static_assert(URNG::max() >= UINT32_MAX, "");
+				const uint64_t hi = rng() & UINT32_MAX;
+				return (hi << 32) | (rng() & UINT32_MAX);
+			}
+		}
+
+		/**
+		 * Build the alias table, by Vose's method. Since the weights
+		 * decrease, the columns holding more than their share are a
+		 * prefix [0,L) and the others a suffix [L,N): two cursors
+		 * replace Vose's work lists, and only the weight of the
+		 * current large column is ever updated.
+		 */
+		void init()
 		{
-			_pdf.reserve(n+1);
-			_pdf.emplace_back(0.0);
-			for (IntType i=1; i<=n; i++)
-				_pdf.emplace_back(std::pow(q + (double)i, -s));
-			return n;
+			const size_t n = _n;
+			double sum = 0.0;
+			for (size_t i = n; 0 < i; i--)   // smallest first, for accuracy
+				sum += weight(i - 1);
+			const double scale = n / sum;
+
+			_table.resize(n);
+			size_t lo = 0, hi = n;    // First column below its share.
+			while (lo < hi)
+			{
+				size_t mid = lo + (hi - lo) / 2;
+				if (weight(mid) * scale < 1.0) hi = mid;
+				else lo = mid + 1;
+			}
+			const size_t L = lo;
+
+			size_t i = L;             // Next small column
+			size_t j = 0;             // Current large column
+			double r = weight(0) * scale;
+			while (j < L)
+			{
+				if (r < 1.0)
+				{
+					// j fell below its share: it becomes a small
+					// column, topped up by the next large one.
+					if (L <= j + 1) break;
+					_table[j] = {float(r), uint32_t(j + 1)};
+					j++;
+					r = weight(j) * scale - (1.0 - r);
+					continue;
+				}
+				if (n <= i) break;
+				const double w = weight(i) * scale;
+				_table[i] = {float(w), uint32_t(j)};
+				r -= 1.0 - w;
+				i++;
+			}
+			// What is left has probability 1, up to rounding errors.
+			for (; j < L; j++) _table[j] = {1.0f, uint32_t(j)};
+			for (; i < n; i++) _table[i] = {1.0f, uint32_t(i)};
 		}
 };
 
@@ -0,0 +1,111 @@
+/*
+ * tests/benchmark/Cover_TreeBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include <omp.h>
+
+#include <opencog/util/Cover_Tree.h>
+
+#include "benchmark.h"
+#include "nn_points.h"
+
+using namespace opencog;
+
+static void bench_build()
+{
+    const size_t n = 20000, dim = 4;
+    std::vector<EuclidPoint> pts = random_points(n, dim, 6);
+
+    auto start = now();
+    {
+        CoverTree<EuclidPoint> tree(4);
+        for (const EuclidPoint& p : pts) tree.insert(p);
+    }
+    double one_by_one = since(start);
+
+    start = now();
+    {
+        CoverTree<EuclidPoint> tree(4, pts);
+    }
+    double batch = since(start);
+
+    printf("building a CoverTree of %zu points in dimension %zu\n",
+           n, dim);
+    printf("insert %g secs\n", one_by_one);
+    printf("insert_batch %g secs\n", batch);
+}
+
+static void bench_query()
+{
+    const size_t n = 20000, dim = 4, n_queries = 20000, k = 10;
+    CoverTree<EuclidPoint> tree(4, random_points(n, dim, 11));
+    std::vector<EuclidPoint> queries = random_points(n_queries, dim, 12);
+
+    size_t found = 0;
+    auto start = now();
+    for (const EuclidPoint& q : queries)
+        found += tree.k_nearest_neighbors(q, k).size();
+    double by_value = since(start);
+
+    std::vector<const EuclidPoint*> out;
+    start = now();
+    for (const EuclidPoint& q : queries) {
+        tree.k_nearest_neighbors(q, k, out);
+        found += out.size();
+    }
+    double by_pointer = since(start);
+
+    printf("%zu %zu-nearest neighbours queries on %zu points "
+           "in dimension %zu (%zu found)\n", n_queries, k, n, dim, found);
+    printf("k_nearest_neighbors %g queries/sec\n", n_queries / by_value);
+    printf("k_nearest_neighbors (pointers) %g queries/sec\n",
+           n_queries / by_pointer);
+
+    start = now();
+    std::vector<std::vector<EuclidPoint> > res =
+        tree.k_nearest_neighbors_batch(queries, k);
+    double batch = since(start);
+    printf("k_nearest_neighbors_batch %g queries/sec (%d threads)\n",
+           n_queries / batch, omp_get_max_threads());
+
+    start = now();
+    for (const EuclidPoint& q : queries)
+        tree.k_nearest_neighbors(q, 1, out);
+    double nearest = since(start);
+    CoverTree<EuclidPoint> qtree(4, queries);
+    start = now();
+    std::vector<std::pair<EuclidPoint,EuclidPoint> > all =
+        tree.all_nearest_neighbors(qtree);
+    double dual = since(start);
+    printf("nearest neighbor one by one %g queries/sec\n",
+           n_queries / nearest);
+    printf("all_nearest_neighbors %g queries/sec\n", n_queries / dual);
+}
+
+int main()
+{
+    bench_build();
+    bench_query();
+    return 0;
+}
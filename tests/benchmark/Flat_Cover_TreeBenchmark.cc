@@ -0,0 +1,73 @@
+/*
+ * tests/benchmark/Flat_Cover_TreeBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include <opencog/util/Flat_Cover_Tree.h>
+
+#include "benchmark.h"
+#include "nn_points.h"
+
+using namespace opencog;
+
+int main()
+{
+    const char* file_name = "Flat_Cover_TreeBenchmark.tree";
+    const size_t n = 20000, n_queries = 20000, k = 10;
+    std::vector<ArrayPoint> pts = random_points<ArrayPoint>(n, array_dim, 5),
+        queries = random_points<ArrayPoint>(n_queries, array_dim, 6);
+
+    auto start = now();
+    CoverTree<ArrayPoint> tree(4, pts);
+    double build = since(start);
+    FlatCoverTree<ArrayPoint>(tree).save(file_name);
+    start = now();
+    FlatCoverTree<ArrayPoint> flat(file_name);
+    double load = since(start);
+
+    std::vector<const ArrayPoint*> out;
+    size_t found = 0;
+    start = now();
+    for (const ArrayPoint& q : queries) {
+        tree.k_nearest_neighbors(q, k, out);
+        found += out.size();
+    }
+    double tree_queries = since(start);
+    start = now();
+    for (const ArrayPoint& q : queries) {
+        flat.k_nearest_neighbors(q, k, out);
+        found += out.size();
+    }
+    double flat_queries = since(start);
+    std::remove(file_name);
+
+    printf("%zu points in dimension %d (%zu neighbours found)\n",
+           n, int(array_dim), found);
+    printf("building the CoverTree %g secs\n", build);
+    printf("loading the saved FlatCoverTree %g secs\n", load);
+    printf("CoverTree %g %zu-NN queries/sec\n",
+           n_queries / tree_queries, k);
+    printf("FlatCoverTree %g %zu-NN queries/sec\n",
+           n_queries / flat_queries, k);
+    return 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * tests/benchmark/benchmark.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_TESTS_BENCHMARK_H
+#define _OPENCOG_TESTS_BENCHMARK_H
+
+#include <chrono>
+
+// Timing helpers shared by the benchmark programs:
+//
+//     auto start = now();
+//     ...
+//     printf("... %g secs\n", since(start));
+
+inline std::chrono::steady_clock::time_point now()
+{
+    return std::chrono::steady_clock::now();
+}
+
+// Seconds elapsed since start.
+inline double since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(now() - start).count();
+}
+
+#endif // _OPENCOG_TESTS_BENCHMARK_H
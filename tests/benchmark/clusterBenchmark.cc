@@ -0,0 +1,149 @@
+/*
+ * tests/benchmark/clusterBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <opencog/util/cluster.h>
+#include <opencog/util/mt19937ar.h>
+
+#include "benchmark.h"
+#include "cluster_data.h"
+
+using namespace opencog;
+
+// distancematrix against distancematrix_parallel, on the rows of ds.
+static void bench_distancematrix(dataset& ds, const std::string& dists,
+                                 bool parallel_mask)
+{
+    int n = ds.nrows;
+    for (char dist : dists) {
+        auto start = now();
+        double** serial =
+            distancematrix(n, ds.ncolumns, ds.data.data(),
+                           ds.mask.data(), ds.weights.data(), dist, 0);
+        double serial_time = since(start);
+
+        start = now();
+        double** parallel =
+            distancematrix_parallel(n, ds.ncolumns, ds.data.data(),
+                                    parallel_mask ? ds.mask.data() : NULL,
+                                    ds.weights.data(), dist, 0);
+        double parallel_time = since(start);
+
+        printf("distancematrix '%c', %d x %d: %f s, "
+               "distancematrix_parallel: %f s (%.1fx)\n",
+               dist, n, ds.ncolumns, serial_time, parallel_time,
+               serial_time / parallel_time);
+        free_matrix(serial, n);
+        free_matrix(parallel, n);
+    }
+}
+
+static void bench_kcluster()
+{
+    const int k = 20;
+    dataset ds(20000, 50, 12);
+    ds.blobs(k, 3, 13);
+    std::vector<double> data = ds.contiguous_data();
+    std::vector<int> clusterid(ds.nrows);
+    double error, parallel_error;
+    int ifound;
+
+    auto start = now();
+    kcluster(k, ds.nrows, ds.ncolumns, ds.data.data(), ds.mask.data(),
+             ds.weights.data(), 0, 4, 'a', 'e', clusterid.data(),
+             &error, &ifound);
+    double serial_time = since(start);
+
+    randGen().seed(3);
+    start = now();
+    kcluster_parallel(k, ds.nrows, ds.ncolumns, data.data(), NULL,
+                      ds.weights.data(), 4, 'a', 'e', clusterid.data(),
+                      &parallel_error, &ifound);
+    double parallel_time = since(start);
+
+    printf("kcluster, %d x %d, %d clusters, 4 passes: %f s, "
+           "error %g\nkcluster_parallel: %f s (%.1fx), error %g\n",
+           ds.nrows, ds.ncolumns, k, serial_time, error, parallel_time,
+           serial_time / parallel_time, parallel_error);
+}
+
+static void bench_pca()
+{
+    const int m = 3000, n = 400, k = 10;
+    std::vector<double> A = low_rank(m, n, n, 0.9, 1e-3, 16);
+
+    auto start = now();
+    std::vector<double> w_full = pca_values(A, m, n);
+    double full_time = since(start);
+
+    printf("pca, %d x %d: %f s\n", m, n, full_time);
+    for (int npower : {0, 1, 2}) {
+        std::vector<double> coordinates(size_t(m) * k),
+            components(size_t(k) * n), w(k);
+        start = now();
+        pca_randomized(m, n, A.data(), k, npower, coordinates.data(),
+                       components.data(), w.data());
+        double time = since(start);
+        double worst = 0;
+        for (int j = 0; j < k; j++)
+            worst = std::max(worst, std::fabs(w[j] / w_full[j] - 1));
+        printf("pca_randomized, %d components, %d power iterations: "
+               "%f s (%.0fx), largest relative error %g\n", k, npower,
+               time, full_time / time, worst);
+    }
+}
+
+// The rank correlations, and Kendall's tau comparing all the pairs of
+// values, timed on a few rows only.
+static void bench_rank()
+{
+    dataset ds(200, 1000, 9);
+    bench_distancematrix(ds, "sk", false);
+
+    const int rows = 20;
+    double total = 0;
+    auto start = now();
+    for (int i = 1; i < rows; i++)
+        for (int j = 0; j < i; j++) {
+            auto xy = common_values(ds, i, j, 0);
+            total += kendall_reference(xy.first, xy.second);
+        }
+    double pairs = 0.5 * ds.nrows * (ds.nrows - 1) /
+        (0.5 * rows * (rows - 1));
+    printf("Kendall's tau over all pairs of values: %f s "
+           "(extrapolated, checksum %g)\n", since(start) * pairs, total);
+}
+
+int main()
+{
+    dataset ds(2000, 200, 5);
+    bench_distancematrix(ds, "ebc", true);
+    bench_kcluster();
+    bench_pca();
+    bench_rank();
+    return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * tests/benchmark/discrete_samplerBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <opencog/util/discrete_sampler.h>
+#include <opencog/util/mt19937ar.h>
+
+#include "benchmark.h"
+
+using namespace opencog;
+
+int main()
+{
+    const size_t n = 100000;
+    const int draws = 1000000;
+    std::vector<double> w(n);
+    MT19937RandGen rng(1);
+    for (double& x : w) x = rng.randdouble();
+
+    long sum = 0;
+    auto start = now();
+    for (int i = 0; i < 100; i++) sum += rng.rand_discrete(w);
+    double per_call = since(start) * draws / 100;
+
+    start = now();
+    std::discrete_distribution<int> dd(w.begin(), w.end());
+    for (int i = 0; i < draws; i++) sum += dd(rng);
+    double stl = since(start);
+
+    start = now();
+    alias_sampler as(w);
+    for (int i = 0; i < draws; i++) sum += rng.rand_discrete(as);
+    double alias = since(start);
+
+    start = now();
+    fenwick_sampler<double> fs(w.begin(), w.end());
+    for (int i = 0; i < draws; i++) sum += rng.rand_discrete(fs);
+    double fenwick = since(start);
+
+    printf("%d draws over %zu weights (sum %ld)\n", draws, n, sum);
+    printf("rand_discrete(vector) %g secs (extrapolated)\n", per_call);
+    printf("std::discrete_distribution %g secs\n", stl);
+    printf("alias_sampler %g secs\n", alias);
+    printf("fenwick_sampler %g secs\n", fenwick);
+    return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * tests/benchmark/fast_rngBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+
+#include <opencog/util/fast_rng.h>
+#include <opencog/util/mt19937ar.h>
+
+#include "benchmark.h"
+
+using namespace opencog;
+
+// The sum is printed so that the draws cannot be optimized away.
+template<typename Rng>
+static void bench(const char* label, Rng& rng, int draws)
+{
+    long sum = 0;
+    auto start = now();
+    for (int i = 0; i < draws; i++)
+        sum += rng.randint(1000) + int(rng.randdouble() * 8);
+    printf("%s %g secs (sum %ld)\n", label, since(start), sum);
+}
+
+int main()
+{
+    const int draws = 20000000;
+    MT19937RandGen mt(1);
+    RandGen& rg = mt;
+    FastRandGen<xoshiro256pp> x(1);
+    FastRandGen<philox4x32> ph(1);
+
+    printf("%d x (randint(1000) + randdouble())\n", draws);
+    bench("MT19937RandGen (virtual)", rg, draws);
+    bench("FastRandGen<xoshiro256pp>", x, draws);
+#ifdef __SIZEOF_INT128__
+    FastRandGen<pcg64> p(1);
+    bench("FastRandGen<pcg64>", p, draws);
+#endif
+    bench("FastRandGen<philox4x32>", ph, draws);
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * tests/benchmark/flat_treeBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include <opencog/util/flat_tree.h>
+#include <opencog/util/hashing.h>
+
+#include "benchmark.h"
+#include "random_tree.h"
+
+using namespace opencog;
+
+int main()
+{
+    const int ntrees = 2000, size = 1000;
+    std::vector<tree<int>> trees(ntrees);
+    std::vector<flat_tree<int>> flats;
+    for (int i = 0; i < ntrees; i++) {
+        build(trees[i], size, i);
+        flats.emplace_back(trees[i]);
+    }
+
+    long sum = 0;
+    auto start = now();
+    for (const auto& tr : trees)
+        for (auto it = tr.begin_post(); it != tr.end_post(); ++it)
+            sum += *it;
+    double tree_post = since(start);
+
+    long fsum = 0;
+    start = now();
+    for (const auto& ft : flats)
+        for (auto it = ft.begin_post(); it != ft.end_post(); ++it)
+            fsum += ft[*it];
+    double flat_post = since(start);
+
+    size_t h = 0;
+    start = now();
+    for (const auto& tr : trees) boost::hash_combine(h, hash_value(tr));
+    double tree_hash = since(start);
+
+    size_t fh = 0;
+    start = now();
+    for (const auto& ft : flats) boost::hash_combine(fh, hash_value(ft));
+    double flat_hash = since(start);
+
+    if (sum != fsum or h != fh) {
+        fprintf(stderr, "tree and flat_tree disagree\n");
+        return 1;
+    }
+
+    printf("%d trees of %d nodes\n", ntrees, size);
+    printf("post-order: tree %g secs, flat_tree %g secs\n",
+           tree_post, flat_post);
+    printf("hash_value: tree %g secs, flat_tree %g secs\n",
+           tree_hash, flat_hash);
+    return 0;
+}
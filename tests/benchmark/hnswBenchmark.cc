@@ -0,0 +1,72 @@
+/*
+ * tests/benchmark/hnswBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include <opencog/util/Cover_Tree.h>
+#include <opencog/util/hnsw.h>
+
+#include "benchmark.h"
+#include "nn_points.h"
+
+using namespace opencog;
+
+int main()
+{
+    const size_t n = 5000, dim = 32, n_queries = 200, k = 10;
+    const double spread = 0.5;
+    std::vector<EuclidPoint> pts = clustered_points(n, dim, 7, spread),
+        queries = clustered_points(n_queries, dim, 8, spread);
+    std::vector<knn_pairs> truth;
+    for (const EuclidPoint& q : queries)
+        truth.push_back(brute_knn(pts, q, k));
+
+    auto start = now();
+    CoverTree<EuclidPoint> tree(4, pts);
+    double tree_build = since(start);
+    std::vector<std::vector<EuclidPoint>> found;
+    start = now();
+    for (const EuclidPoint& q : queries)
+        found.push_back(tree.k_nearest_neighbors(q, k));
+    double tree_query = since(start) / n_queries;
+
+    start = now();
+    hnsw_index<EuclidPoint> index;
+    index.insert(pts);
+    double hnsw_build = since(start);
+
+    printf("%zu clustered points in dimension %zu, %zu-NN\n", n, dim, k);
+    printf("CoverTree: build %g secs, recall %g, %g ms/query\n",
+           tree_build, recall(truth, found), 1000 * tree_query);
+    printf("hnsw_index (M=%u): build %g secs\n", index.M(), hnsw_build);
+    for (unsigned ef : {10, 20, 40, 80, 160, 320}) {
+        found.clear();
+        start = now();
+        for (const EuclidPoint& q : queries)
+            found.push_back(index.k_nearest_neighbors(q, k, ef));
+        double t = since(start) / n_queries;
+        printf("  ef=%u: recall %g, %g ms/query (%gx faster)\n",
+               ef, recall(truth, found), 1000 * t, tree_query / t);
+    }
+    return 0;
+}
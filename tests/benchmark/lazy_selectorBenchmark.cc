@@ -0,0 +1,45 @@
+/*
+ * tests/benchmark/lazy_selectorBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+
+#include <opencog/util/dorepeat.h>
+#include <opencog/util/lazy_random_selector.h>
+#include <opencog/util/mt19937ar.h>
+
+#include "benchmark.h"
+
+using namespace opencog;
+
+int main()
+{
+    // A few million draws in a range of billions.
+    const unsigned int u = 4000000000U, k = 2000000;
+    MT19937RandGen rnd(1);
+    unsigned long sum = 0;
+    auto start = now();
+    lazy_random_selector lrs(u, rnd);
+    dorepeat(k) sum += lrs();
+    printf("%u draws without replacement in [0,%u) %g secs (sum %lu)\n",
+           k, u, since(start), sum);
+    return 0;
+}
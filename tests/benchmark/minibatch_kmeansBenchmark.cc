@@ -0,0 +1,69 @@
+/*
+ * tests/benchmark/minibatch_kmeansBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include <opencog/util/cluster.h>
+#include <opencog/util/minibatch_kmeans.h>
+#include <opencog/util/mt19937ar.h>
+
+#include "benchmark.h"
+#include "cluster_data.h"
+
+using namespace opencog;
+
+int main()
+{
+    const int k = 20;
+    dataset ds(200000, 20, 7);
+    ds.blobs(k, 4, 7);
+    int n = ds.nrows, m = ds.ncolumns;
+    std::vector<double> data = ds.contiguous_data();
+    std::vector<double> weights(m, 1);
+
+    randGen().seed(1);
+    auto start = now();
+    std::vector<int> clusterid(n);
+    double error;
+    int ifound;
+    kcluster_parallel(k, n, m, data.data(), NULL, weights.data(), 1,
+                      'a', 'e', clusterid.data(), &error, &ifound);
+    double full_time = since(start);
+    // kcluster's error is the mean over the columns.
+    error *= m;
+    printf("%d x %d, %d clusters: kcluster_parallel, 1 pass: %f s, "
+           "error %g\n", n, m, k, full_time, error);
+
+    for (size_t batch : {1024, 4096}) {
+        start = now();
+        minibatch_kmeans mbk(k, m, batch, 8);
+        mbk.fit(ds.values.begin(), ds.values.end());
+        double mbk_time = since(start);
+        double mbk_error = mbk.error(data.data(), n);
+        printf("minibatch_kmeans, 1 epoch, batches of %zu: %f s "
+               "(%.1fx), error %g (%+.1f%%)\n", batch, mbk_time,
+               full_time / mbk_time, mbk_error,
+               100 * (mbk_error / error - 1));
+    }
+    return 0;
+}
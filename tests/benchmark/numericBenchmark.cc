@@ -0,0 +1,91 @@
+/*
+ * tests/benchmark/numericBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <opencog/util/numeric.h>
+
+#include "benchmark.h"
+
+using namespace std;
+using namespace opencog;
+
+// Same layout as vector, but the templates of numeric.h do not use the
+// SIMD kernels for it.
+template<typename T>
+struct plain_vec : public vector<T>
+{
+    using vector<T>::vector;
+};
+
+// Keeps the distances from being optimized away.
+static volatile double sink;
+
+// Distances from the first vector to all the others; p < 0 stands for
+// the angular distance.
+template<typename Vec>
+static double bench(const vector<Vec>& vs, double p)
+{
+    auto start = now();
+    typedef typename Vec::value_type T;
+    double sum = 0;
+    for (size_t i = 1; i < vs.size(); i++) {
+        if (p < 0)
+            sum += angular_distance<Vec, T>(vs[0], vs[i]);
+        else
+            sum += p_norm_distance<Vec, T>(vs[0], vs[i], p);
+    }
+    sink = sum;
+    return since(start);
+}
+
+int main()
+{
+    const size_t dim = 256, n_vec = 20000;
+    mt19937 gen(3);
+    uniform_real_distribution<float> unif(0, 1);
+    vector<vector<float>> vs(n_vec, vector<float>(dim));
+    vector<plain_vec<float>> ref(n_vec);
+    vector<float> data;
+    for (size_t i = 0; i < n_vec; i++) {
+        for (float& x : vs[i]) x = unif(gen);
+        ref[i].assign(vs[i].begin(), vs[i].end());
+        data.insert(data.end(), vs[i].begin(), vs[i].end());
+    }
+
+    printf("%zu distances between float vectors of size %zu\n",
+           n_vec, dim);
+    const char* names[] = {"max", "manhattan", "euclidean", "angular"};
+    double ps[] = {0, 1, 2, -1};
+    for (int k = 0; k < 4; k++)
+        printf("%s: template %g secs, kernel %g secs\n", names[k],
+               bench(ref, ps[k]), bench(vs, ps[k]));
+
+    vector<float> out(n_vec);
+    auto start = now();
+    p_norm_distance_batch(data.data(), data.data(), n_vec, dim, 2.0,
+                          out.data());
+    printf("euclidean, batch %g secs\n", since(start));
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * tests/benchmark/randomBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include <opencog/util/random.h>
+#include <opencog/util/mt19937ar.h>
+
+#include "benchmark.h"
+
+using namespace opencog;
+
+static void bench_randint()
+{
+    const int size = 20000000;
+    MT19937RandGen rng(1);
+    long sum = 0;
+
+    rng.set_legacy_randint(true);
+    auto start = now();
+    for (int i = 0; i < size; ++i)
+        sum += rng.randint(1000 + (i & 255));
+    double legacy = since(start);
+
+    rng.set_legacy_randint(false);
+    start = now();
+    for (int i = 0; i < size; ++i)
+        sum += rng.randint(1000 + (i & 255));
+    double lemire = since(start);
+
+    start = now();
+    for (int i = 0; i < size; ++i)
+        sum += rng.randbounded32(1000 + (i & 255));
+    double direct = since(start);
+
+    printf("%d x randint(n): modulo %g secs, multiply-shift %g secs, "
+           "randbounded32 %g secs (sum %ld)\n",
+           size, legacy, lemire, direct, sum);
+}
+
+static void bench_fill()
+{
+    const size_t size = 10000000;
+    std::vector<double> v(size);
+    MT19937RandGen rng(1);
+
+    auto start = now();
+    for (double& x : v) x = rng.randdouble_one_excluded();
+    double per_call_uniform = since(start);
+    start = now();
+    fill_uniform(v.data(), size);
+    double bulk_uniform = since(start);
+
+    start = now();
+    for (double& x : v) x = gaussian_rand(0.0, 1.0, rng);
+    double per_call_gaussian = since(start);
+    start = now();
+    fill_gaussian(v.data(), size, 0.0, 1.0);
+    double bulk_gaussian = since(start);
+
+    printf("%zu doubles\n", size);
+    printf("uniform: per call %g secs, fill_uniform %g secs\n",
+           per_call_uniform, bulk_uniform);
+    printf("gaussian: gaussian_rand %g secs, fill_gaussian %g secs\n",
+           per_call_gaussian, bulk_gaussian);
+}
+
+int main()
+{
+    bench_randint();
+    bench_fill();
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * tests/benchmark/reservoirBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+#include <opencog/util/fast_rng.h>
+#include <opencog/util/reservoir.h>
+
+#include "benchmark.h"
+
+using namespace opencog;
+
+int main()
+{
+    const size_t n = 20000000, k = 1000;
+    std::vector<int> items(n);
+    std::iota(items.begin(), items.end(), 0);
+    FastRandGen<> rng(1);
+
+    auto start = now();
+    reservoir_sampler<int, FastRandGen<>> rs(k, rng);
+    for (int i : items) rs.add(i);
+    double one_by_one = since(start);
+
+    start = now();
+    reservoir_sampler<int, FastRandGen<>> rr(k, rng);
+    rr.add(items.begin(), items.end());
+    double skipping = since(start);
+
+    start = now();
+    weighted_reservoir_sampler<int, FastRandGen<>> ws(k, rng);
+    for (int i : items) ws.add(i, 1 + i % 7);
+    double weighted = since(start);
+
+    printf("sampling %zu of %zu items\n", k, n);
+    printf("reservoir_sampler::add(x) %g secs\n", one_by_one);
+    printf("reservoir_sampler::add(from, to) %g secs\n", skipping);
+    printf("weighted_reservoir_sampler %g secs\n", weighted);
+    return 0;
+}
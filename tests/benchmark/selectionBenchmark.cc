@@ -0,0 +1,64 @@
+/*
+ * tests/benchmark/selectionBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <iterator>
+#include <vector>
+
+#include <opencog/util/mt19937ar.h>
+#include <opencog/util/selection.h>
+
+#include "benchmark.h"
+
+using namespace opencog;
+
+int main()
+{
+    const size_t n = 2000000, n_select = 2000000;
+    const unsigned t = 4;
+    std::vector<double> scores(n);
+    MT19937RandGen rng(1);
+    for (double& s : scores) s = rng.randdouble();
+    tournament_selection ts(t, rng);
+
+    std::vector<double> values;
+    values.reserve(n_select);
+    auto start = now();
+    ts(scores.begin(), scores.end(), std::back_inserter(values),
+       n_select);
+    double single = since(start);
+
+    std::vector<unsigned> winners(n_select);
+    start = now();
+    ts.select_batch(scores.data(), n, winners.data(), n_select);
+    double batch = since(start);
+
+    start = now();
+    ts.select_batch(scores.data(), n, winners.data(), n_select, true);
+    double parallel = since(start);
+
+    printf("%zu tournaments of size %u among %zu\n", n_select, t, n);
+    printf("operator() %g secs\n", single);
+    printf("select_batch %g secs\n", batch);
+    printf("select_batch, parallel %g secs\n", parallel);
+    return 0;
+}
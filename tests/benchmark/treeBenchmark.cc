@@ -0,0 +1,61 @@
+/*
+ * tests/benchmark/treeBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+
+#include <opencog/util/tree.h>
+#include <opencog/util/hashing.h>
+
+#include "benchmark.h"
+#include "random_tree.h"
+
+using namespace opencog;
+
+int main()
+{
+    hashed_tree<int> tr;
+    build(tr, 20000, 5);
+    hashed_tree<int>::pre_order_iterator leaf = tr.begin_leaf();
+    const int nedits = 200;
+
+    size_t h = 0;
+    auto start = now();
+    for (int i = 0; i < nedits; i++) {
+        tr.replace(leaf, i);
+        boost::hash_combine(h, hash_value(tr));
+    }
+    double full = since(start);
+
+    start = now();
+    for (int i = 0; i < nedits; i++) {
+        tr.replace(leaf, i);
+        boost::hash_combine(h, cached_tree_hash()(tr));
+    }
+    double cached = since(start);
+
+    printf("%d leaf edits on a %d node tree: hash_value %g secs, "
+           "cached hash %g secs\n", nedits, tr.size(), full, cached);
+    printf("node of tree<int>: %zu bytes, of hashed_tree<int>: %zu "
+           "bytes\n", sizeof(tree_node_<int>),
+           sizeof(tree_node_<int, true>));
+    return 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * tests/benchmark/tree_allocatorBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+
+#include <opencog/util/tree.h>
+#include <opencog/util/tree_allocator.h>
+
+#include "benchmark.h"
+#include "random_tree.h"
+
+using namespace opencog;
+
+template<typename Tree>
+static void bench(const char* label, int ntrees, int size)
+{
+    auto start = now();
+    size_t total = 0;
+    for (int i = 0; i < ntrees; i++) {
+        Tree tr;
+        build(tr, size, i);
+        Tree cp(tr);
+        total += cp.size();
+    }
+    printf("%s: %d trees of %d nodes built, copied and destroyed "
+           "in %g secs (%zu nodes)\n", label, ntrees, size, since(start),
+           total);
+}
+
+int main()
+{
+    bench<tree<int>>("std::allocator", 2000, 1000);
+    bench<pooled_tree<int>>("pool allocator", 2000, 1000);
+    bench<tree<int>>("std::allocator", 200000, 10);
+    bench<pooled_tree<int>>("pool allocator", 200000, 10);
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * tests/benchmark/zipfBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <opencog/util/zipf.h>
+
+#include "benchmark.h"
+
+using namespace opencog;
+
+static std::mt19937 gen(2);
+
+// Print the draws per second of each sampler.
+static void bench_throughput(unsigned long n, size_t ndraw)
+{
+    std::vector<unsigned long> draws(ndraw);
+    unsigned long sum = 0;
+    printf("Throughput, N=%lu, %zu draws, s=1\n", n, ndraw);
+
+    zipf_distribution<> zipf(n, 1.0);
+    auto start = now();
+    for (size_t i = 0; i < ndraw; i++) sum += zipf(gen);
+    printf("rejection-inversion: %.3g draws/sec\n", ndraw / since(start));
+
+    start = now();
+    zipf(gen, draws.data(), ndraw);
+    printf("batched rejection-inversion: %.3g draws/sec\n",
+           ndraw / since(start));
+
+    start = now();
+    zipf_table_distribution<> table(n, 1.0);
+    printf("alias table: built in %.3g secs, ", since(start));
+    start = now();
+    for (size_t i = 0; i < ndraw; i++) sum += table(gen);
+    printf("%.3g draws/sec\n", ndraw / since(start));
+
+    start = now();
+    table(gen, draws.data(), ndraw);
+    printf("batched alias table: %.3g draws/sec\n", ndraw / since(start));
+
+    // What zipf_table_distribution used to do.
+    start = now();
+    std::vector<double> pdf(n + 1, 0.0);
+    for (unsigned long i = 1; i <= n; i++) pdf[i] = std::pow(i, -1.0);
+    std::discrete_distribution<unsigned long> dd(pdf.begin(), pdf.end());
+    printf("std::discrete_distribution: built in %.3g secs, ", since(start));
+    start = now();
+    for (size_t i = 0; i < ndraw; i++) sum += dd(gen);
+    printf("%.3g draws/sec\n", ndraw / since(start));
+
+    for (unsigned long draw : draws) sum += draw;
+    printf("checksum %lu\n\n", sum);
+}
+
+int main()
+{
+    bench_throughput(1000, 10000000);
+    bench_throughput(10000000, 10000000);
+    return 0;
+}
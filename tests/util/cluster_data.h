@@ -0,0 +1,189 @@
+/*
+ * tests/util/cluster_data.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_TESTS_CLUSTER_DATA_H
+#define _OPENCOG_TESTS_CLUSTER_DATA_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include <opencog/util/cluster.h>
+#include <opencog/util/mt19937ar.h>
+
+// Data shared by the clustering suite and benchmark.
+
+// Data and mask, in the ragged arrays of the C clustering library.
+struct dataset
+{
+    int nrows, ncolumns;
+    std::vector<std::vector<double>> values;
+    std::vector<std::vector<int>> valid;
+    std::vector<double*> data;
+    std::vector<int*> mask;
+    std::vector<double> weights;
+
+    // missing is the probability that a value is missing.
+    dataset(int nrows, int ncolumns, int seed, double missing = 0)
+        : nrows(nrows), ncolumns(ncolumns),
+          values(nrows, std::vector<double>(ncolumns)),
+          valid(nrows, std::vector<int>(ncolumns, 1)),
+          weights(std::max(nrows, ncolumns))
+    {
+        opencog::MT19937RandGen rng(seed);
+        for (int i = 0; i < nrows; i++)
+            for (int j = 0; j < ncolumns; j++) {
+                values[i][j] = rng.randdouble() * 10 - 5;
+                if (rng.randdouble() < missing) valid[i][j] = 0;
+            }
+        for (double& w : weights) w = 0.5 + rng.randdouble();
+        for (int i = 0; i < nrows; i++) {
+            data.push_back(values[i].data());
+            mask.push_back(valid[i].data());
+        }
+    }
+
+    // Make the rows k clusters, of width spread, numbered in the order
+    // of their first row.
+    std::vector<int> blobs(int k, double spread, int seed)
+    {
+        opencog::MT19937RandGen rng(seed);
+        std::vector<std::vector<double>> centers(k);
+        for (auto& c : centers)
+            for (int j = 0; j < ncolumns; j++)
+                c.push_back(rng.randdouble() * 10 - 5);
+        std::vector<int> clusterid(nrows), label(k, -1);
+        int next = 0;
+        for (int i = 0; i < nrows; i++) {
+            int c = i < k ? i : rng.randint(k);
+            for (int j = 0; j < ncolumns; j++)
+                values[i][j] = centers[c][j] +
+                    spread * (rng.randdouble() - 0.5);
+            if (label[c] < 0) label[c] = next++;
+            clusterid[i] = label[c];
+        }
+        return clusterid;
+    }
+
+    // Contiguous copies of the data and mask.
+    std::vector<double> contiguous_data() const
+    {
+        std::vector<double> res;
+        for (const auto& row : values)
+            res.insert(res.end(), row.begin(), row.end());
+        return res;
+    }
+    std::vector<unsigned char> contiguous_mask() const
+    {
+        std::vector<unsigned char> res;
+        for (const auto& row : valid)
+            res.insert(res.end(), row.begin(), row.end());
+        return res;
+    }
+};
+
+inline void free_matrix(double** m, int n)
+{
+    if (m == NULL) return;
+    for (int i = 1; i < n; i++) free(m[i]);
+    free(m);
+}
+
+// Centered matrix of rank at most r, row after row, whose singular
+// values decrease by decay, plus uniform noise.
+inline std::vector<double> low_rank(int m, int n, int r, double decay,
+                                    double noise, int seed)
+{
+    opencog::MT19937RandGen rng(seed);
+    std::vector<double> X(size_t(m) * r), Y(size_t(r) * n);
+    for (double& x : X) x = rng.randdouble() - 0.5;
+    for (double& y : Y) y = rng.randdouble() - 0.5;
+    std::vector<double> A(size_t(m) * n, 0);
+    double scale = 1;
+    for (int p = 0; p < r; p++, scale *= decay)
+        for (int i = 0; i < m; i++)
+            for (int j = 0; j < n; j++)
+                A[size_t(i) * n + j] += scale * X[i * r + p] * Y[p * n + j];
+    for (double& a : A) a += noise * (rng.randdouble() - 0.5);
+    for (int j = 0; j < n; j++) {
+        double mean = 0;
+        for (int i = 0; i < m; i++) mean += A[size_t(i) * n + j] / m;
+        for (int i = 0; i < m; i++) A[size_t(i) * n + j] -= mean;
+    }
+    return A;
+}
+
+// w of pca, on a copy of A
+inline std::vector<double> pca_values(const std::vector<double>& A, int m,
+                                      int n)
+{
+    std::vector<double> u(A);
+    int p = std::min(m, n);
+    std::vector<double> v(size_t(p) * p), w(p);
+    std::vector<double*> urows(m), vrows(p);
+    for (int i = 0; i < m; i++) urows[i] = &u[size_t(i) * n];
+    for (int i = 0; i < p; i++) vrows[i] = &v[size_t(i) * p];
+    pca(m, n, urows.data(), vrows.data(), w.data());
+    return w;
+}
+
+// Values of elements i and j of ds (rows, or columns if transpose)
+// that are valid in both.
+inline std::pair<std::vector<double>, std::vector<double>>
+common_values(const dataset& ds, int i, int j, int transpose)
+{
+    std::pair<std::vector<double>, std::vector<double>> res;
+    int m = transpose ? ds.nrows : ds.ncolumns;
+    for (int k = 0; k < m; k++) {
+        int vi = transpose ? ds.valid[k][i] : ds.valid[i][k];
+        int vj = transpose ? ds.valid[k][j] : ds.valid[j][k];
+        if (not (vi and vj)) continue;
+        res.first.push_back(transpose ? ds.values[k][i] : ds.values[i][k]);
+        res.second.push_back(transpose ? ds.values[k][j] : ds.values[j][k]);
+    }
+    return res;
+}
+
+// One minus Kendall's tau, comparing all pairs, as cluster.c used to.
+inline double kendall_reference(const std::vector<double>& x,
+                                const std::vector<double>& y)
+{
+    int con = 0, dis = 0, exx = 0, exy = 0;
+    int m = x.size();
+    if (m < 2) return 0;
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < i; j++) {
+            if ((x[i] < x[j] and y[i] < y[j]) or
+                (x[i] > x[j] and y[i] > y[j])) con++;
+            if ((x[i] < x[j] and y[i] > y[j]) or
+                (x[i] > x[j] and y[i] < y[j])) dis++;
+            if (x[i] == x[j] and y[i] != y[j]) exx++;
+            if (x[i] != x[j] and y[i] == y[j]) exy++;
+        }
+    double denomx = con + dis + exx, denomy = con + dis + exy;
+    if (denomx == 0 or denomy == 0) return 1;
+    return 1 - (con - dis) / std::sqrt(denomx * denomy);
+}
+
+#endif // _OPENCOG_TESTS_CLUSTER_DATA_H
@@ -0,0 +1,144 @@
+/*
+ * tests/util/nn_points.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_TESTS_NN_POINTS_H
+#define _OPENCOG_TESTS_NN_POINTS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include <opencog/util/mt19937ar.h>
+#include <opencog/util/oc_assert.h>
+
+// Points and brute force answers shared by the nearest neighbour
+// suites (CoverTree, FlatCoverTree and hnsw_index) and benchmarks.
+
+// Euclidean point, with an id so that points at distance 0 can differ.
+template<typename Coords>
+struct BasicPoint
+{
+    Coords x;
+    int id;
+
+    double distance(const BasicPoint& p) const
+    {
+        double s = 0;
+        for (size_t i = 0; i < x.size(); i++)
+            s += (x[i] - p.x[i]) * (x[i] - p.x[i]);
+        return std::sqrt(s);
+    }
+    bool operator==(const BasicPoint& p) const
+    {
+        return id == p.id and x == p.x;
+    }
+    void print() const { printf("%d\n", id); }
+};
+
+typedef BasicPoint<std::vector<double>> EuclidPoint;
+
+// Trivially copyable, so that trees of it can be saved.
+const size_t array_dim = 4;
+typedef BasicPoint<std::array<double, array_dim>> ArrayPoint;
+
+inline void resize_coords(std::vector<double>& x, size_t dim)
+{
+    x.resize(dim);
+}
+
+template<size_t N>
+void resize_coords(std::array<double, N>&, size_t dim)
+{
+    OC_ASSERT(dim == N, "the dimension of array points is fixed");
+}
+
+// n points, uniform in the unit cube.
+template<typename Point = EuclidPoint>
+std::vector<Point> random_points(size_t n, size_t dim, int seed)
+{
+    opencog::MT19937RandGen rng(seed);
+    std::vector<Point> pts(n);
+    for (size_t i = 0; i < n; i++) {
+        pts[i].id = i;
+        resize_coords(pts[i].x, dim);
+        for (size_t d = 0; d < dim; d++)
+            pts[i].x[d] = rng.randdouble();
+    }
+    return pts;
+}
+
+// n points around the same 20 centers, whatever the seed, rather than
+// uniform, for more realistic neighborhoods; spread is the width of
+// the clusters.
+template<typename Point = EuclidPoint>
+std::vector<Point> clustered_points(size_t n, size_t dim, int seed,
+                                    double spread = 0.1)
+{
+    opencog::MT19937RandGen crng(0);
+    std::vector<std::vector<double>> centers(20);
+    for (auto& c : centers)
+        for (size_t d = 0; d < dim; d++) c.push_back(crng.randdouble());
+    opencog::MT19937RandGen rng(seed);
+    std::vector<Point> pts(n);
+    for (size_t i = 0; i < n; i++) {
+        pts[i].id = i;
+        resize_coords(pts[i].x, dim);
+        const auto& c = centers[rng.randint(centers.size())];
+        for (size_t d = 0; d < dim; d++)
+            pts[i].x[d] = c[d] + spread * (rng.randdouble() - 0.5);
+    }
+    return pts;
+}
+
+// (distance, id) pairs, nearest first.
+typedef std::vector<std::pair<double, int>> knn_pairs;
+
+// The k nearest points to p, by brute force.
+template<typename Point>
+knn_pairs brute_knn(const std::vector<Point>& pts, const Point& p, size_t k)
+{
+    knn_pairs d;
+    for (const Point& q : pts) d.push_back({p.distance(q), q.id});
+    std::sort(d.begin(), d.end());
+    d.resize(std::min(k, d.size()));
+    return d;
+}
+
+// Fraction of the true k nearest neighbors found.
+template<typename Point>
+double recall(const std::vector<knn_pairs>& truth,
+              const std::vector<std::vector<Point>>& found)
+{
+    size_t hits = 0, total = 0;
+    for (size_t i = 0; i < truth.size(); i++) {
+        total += truth[i].size();
+        for (const Point& p : found[i])
+            for (const auto& t : truth[i])
+                hits += t.second == p.id;
+    }
+    return double(hits) / total;
+}
+
+#endif // _OPENCOG_TESTS_NN_POINTS_H
@@ -0,0 +1,44 @@
+/*
+ * tests/util/random_tree.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_TESTS_RANDOM_TREE_H
+#define _OPENCOG_TESTS_RANDOM_TREE_H
+
+#include <climits>
+#include <vector>
+
+// Grow a random-ish tree of n nodes, deterministic in seed: node i
+// is labelled i % nlabels and appended to a random earlier node.
+template<typename Tree>
+void build(Tree& tr, int n, unsigned seed, int nlabels = INT_MAX)
+{
+    typedef typename Tree::pre_order_iterator pre_it;
+    std::vector<pre_it> nodes;
+    nodes.push_back(tr.set_head(0));
+    for (int i = 1; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        pre_it parent = nodes[(seed >> 8) % nodes.size()];
+        nodes.push_back(tr.append_child(parent, i % nlabels));
+    }
+}
+
+#endif // _OPENCOG_TESTS_RANDOM_TREE_H